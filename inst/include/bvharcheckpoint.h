@@ -0,0 +1,155 @@
+#ifndef BVHARCHECKPOINT_H
+#define BVHARCHECKPOINT_H
+
+#include <RcppEigen.h>
+#include <boost/random/mersenne_twister.hpp>
+#include <fstream>
+#include <sstream>
+#include <cstdio> // std::rename, std::remove
+#include <type_traits>
+
+namespace bvhar {
+
+// Binary State of MCMC
+//
+// Scalars are written as raw bytes, Eigen objects as rows, cols, and column-major values, and RNG as its text state.
+// Reading checks that every Eigen object keeps the size of the sampler built from the same data and specification.
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value>::type write_state(std::ostream& os, const T& val) {
+	os.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value>::type read_state(std::istream& is, T& val) {
+	is.read(reinterpret_cast<char*>(&val), sizeof(T));
+}
+
+template <typename Derived>
+inline void write_state(std::ostream& os, const Eigen::PlainObjectBase<Derived>& mat) {
+	int rows = mat.rows();
+	int cols = mat.cols();
+	write_state(os, rows);
+	write_state(os, cols);
+	os.write(reinterpret_cast<const char*>(mat.data()), sizeof(typename Derived::Scalar) * mat.size());
+}
+
+template <typename Derived>
+inline void read_state(std::istream& is, Eigen::PlainObjectBase<Derived>& mat) {
+	int rows, cols;
+	read_state(is, rows);
+	read_state(is, cols);
+	if (!is || rows != mat.rows() || cols != mat.cols()) {
+		Rcpp::stop("Checkpoint does not match the model.");
+	}
+	is.read(reinterpret_cast<char*>(mat.data()), sizeof(typename Derived::Scalar) * mat.size());
+}
+
+inline void write_state(std::ostream& os, const boost::random::mt19937& rng) {
+	std::ostringstream rng_state;
+	rng_state << rng;
+	std::string rng_str = rng_state.str();
+	int len = rng_str.size();
+	write_state(os, len);
+	os.write(rng_str.data(), len);
+}
+
+inline void read_state(std::istream& is, boost::random::mt19937& rng) {
+	int len;
+	read_state(is, len);
+	std::string rng_str(len, ' ');
+	is.read(&rng_str[0], len);
+	std::istringstream rng_state(rng_str);
+	rng_state >> rng;
+}
+
+// Checkpoint of Multi-chain MCMC
+//
+// Every save_every iterations, the state of every chain is written to path (through a temporary file, so a preempted write keeps the previous checkpoint).
+// With resume, chains start from the state in path and continue the same draws as an uninterrupted run.
+// Empty spec list turns off the checkpoint.
+class McmcCheckpoint {
+public:
+	McmcCheckpoint(Rcpp::List& spec, int num_iter)
+	: num_iter(num_iter), is_active(spec.size() > 0), save_every(num_iter), is_resume(false) {
+		if (is_active) {
+			path = Rcpp::as<std::string>(spec["path"]);
+			save_every = spec["save_every"];
+			is_resume = spec["resume"];
+		}
+	}
+	virtual ~McmcCheckpoint() = default;
+	bool isActive() const {
+		return is_active;
+	}
+	bool isResume() const {
+		return is_active && is_resume;
+	}
+	int nextSave(int step) const {
+		return std::min((step / save_every + 1) * save_every, num_iter);
+	}
+	bool isSaveStep(int step) const {
+		return is_active && step % save_every == 0 && step < num_iter;
+	}
+	template <typename T>
+	void save(const std::vector<std::unique_ptr<T>>& mcmc_objs, int step) const {
+		std::string tmp_path = path + ".tmp";
+		std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+		if (!os) {
+			Rcpp::stop("Cannot write checkpoint to '" + tmp_path + "'.");
+		}
+		os.write(magic(), 8);
+		write_state(os, num_iter);
+		write_state(os, static_cast<int>(mcmc_objs.size()));
+		write_state(os, step);
+		for (const auto& mcmc : mcmc_objs) {
+			mcmc->saveState(os);
+		}
+		os.close();
+		if (!os) {
+			Rcpp::stop("Cannot write checkpoint to '" + tmp_path + "'.");
+		}
+		if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+			std::remove(path.c_str()); // rename does not overwrite on Windows
+			if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+				Rcpp::stop("Cannot write checkpoint to '" + path + "'.");
+			}
+		}
+	}
+	// Returns the step where the chains restart
+	template <typename T>
+	int load(std::vector<std::unique_ptr<T>>& mcmc_objs) const {
+		std::ifstream is(path, std::ios::binary);
+		if (!is) {
+			Rcpp::stop("Cannot read checkpoint from '" + path + "'.");
+		}
+		std::string file_magic(8, ' ');
+		is.read(&file_magic[0], 8);
+		int file_iter, num_chains, step;
+		read_state(is, file_iter);
+		read_state(is, num_chains);
+		read_state(is, step);
+		if (!is || file_magic != magic() || file_iter != num_iter || num_chains != static_cast<int>(mcmc_objs.size())) {
+			Rcpp::stop("Checkpoint does not match the model.");
+		}
+		for (auto& mcmc : mcmc_objs) {
+			mcmc->loadState(is);
+		}
+		if (!is) {
+			Rcpp::stop("Checkpoint is truncated.");
+		}
+		return step;
+	}
+private:
+	int num_iter;
+	bool is_active;
+	int save_every;
+	bool is_resume;
+	std::string path;
+	static const char* magic() {
+		return "BVHRCKP3"; // file type and format version
+	}
+};
+
+} // namespace bvhar
+
+#endif // BVHARCHECKPOINT_H
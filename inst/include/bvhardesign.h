@@ -57,6 +57,34 @@ inline Eigen::MatrixXd build_vhar(int dim, int week, int month, bool include_mea
   return HARtrans.block(0, 0, 3 * dim, month * dim);
 }
 
+inline Eigen::MatrixXd build_har_x0(const Eigen::MatrixXd& y, const Eigen::VectorXi& har_order, bool include_mean) {
+  int month = har_order.maxCoeff(); // the longest order decides the sample
+  int num_design = y.rows() - month; // s = n - month
+  int dim = y.cols();
+  int num_har = har_order.size();
+  Eigen::MatrixXd res(num_design, dim * num_har + (include_mean ? 1 : 0)); // X1 = [daily, weekly, monthly, ..., 1]: s x (3m + 1)
+  Eigen::RowVectorXd run_sum(dim);
+  for (int j = 0; j < num_har; j++) {
+    int order = har_order[j];
+    run_sum = y.middleRows(month - order, order).colwise().sum(); // y_(t - 1) + ... + y_(t - order) for the first t
+    res.block(0, j * dim, 1, dim) = run_sum / order;
+    for (int i = 1; i < num_design; i++) {
+      run_sum += y.row(month + i - 1) - y.row(month + i - 1 - order); // slide the window by one
+      res.block(i, j * dim, 1, dim) = run_sum / order;
+    }
+  }
+  if (include_mean) {
+    res.col(dim * num_har).setOnes(); // the last column for constant term
+  }
+  return res;
+}
+
+inline Eigen::MatrixXd build_har_x0(const Eigen::MatrixXd& y, int week, int month, bool include_mean) {
+  Eigen::VectorXi har_order(3);
+  har_order << 1, week, month;
+  return build_har_x0(y, har_order, include_mean);
+}
+
 inline Eigen::MatrixXd build_ydummy(int p, const Eigen::VectorXd& sigma, double lambda,
 																		const Eigen::VectorXd& daily, const Eigen::VectorXd& weekly, const Eigen::VectorXd& monthly,
 																		bool include_mean) {
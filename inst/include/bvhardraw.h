@@ -54,10 +54,13 @@ inline Eigen::VectorXd build_ssvs_sd(Eigen::VectorXd spike_sd, Eigen::VectorXd s
 // 
 // In MCMC, this function builds \eqn{L} given \eqn{a} vector.
 // 
+// Dim can be the fixed k to build L on the stack (see dispatch_dim()).
+// 
 // @param dim Dimension (dim x dim) of L
 // @param lower_vec Vector a
-inline Eigen::MatrixXd build_inv_lower(int dim, Eigen::VectorXd lower_vec) {
-  Eigen::MatrixXd res = Eigen::MatrixXd::Identity(dim, dim);
+template <int Dim = Eigen::Dynamic, typename Derived>
+inline Eigen::Matrix<double, Dim, Dim> build_inv_lower(int dim, const Eigen::MatrixBase<Derived>& lower_vec) {
+  Eigen::Matrix<double, Dim, Dim> res = Eigen::Matrix<double, Dim, Dim>::Identity(dim, dim);
   int id = 0;
   for (int i = 1; i < dim; i++) {
     res.row(i).segment(0, i) = lower_vec.segment(id, i);
@@ -66,64 +69,63 @@ inline Eigen::MatrixXd build_inv_lower(int dim, Eigen::VectorXd lower_vec) {
   return res;
 }
 
-// Generating the Diagonal Component of Cholesky Factor in SSVS Gibbs Sampler
-// 
-// In MCMC process of SSVS, this function generates the diagonal component \eqn{\Psi} from variance matrix
-// 
-// @param sse_mat The result of \eqn{Z_0^T Z_0 = (Y_0 - X_0 \hat{A})^T (Y_0 - X_0 \hat{A})}
-// @param DRD Inverse of matrix product between \eqn{D_j} and correlation matrix \eqn{R_j}
-// @param shape Gamma shape parameters for precision matrix
-// @param rate Gamma rate parameters for precision matrix
-// @param num_design The number of sample used, \eqn{n = T - p}
-inline void ssvs_chol_diag(Eigen::VectorXd& chol_diag, Eigen::MatrixXd& sse_mat, Eigen::VectorXd& DRD,
-													 Eigen::VectorXd& shape, Eigen::VectorXd& rate, int num_design, boost::mt19937& rng) {
-  int dim = sse_mat.cols();
-  int num_param = DRD.size();
-  Eigen::MatrixXd inv_DRD = Eigen::MatrixXd::Zero(num_param, num_param);
-  inv_DRD.diagonal() = 1 / DRD.array().square();
-  Eigen::VectorXd sse_colvec(dim - 1); // sj = (s1j, ..., s(j-1, j)) from SSE
-  shape.array() += (double)num_design / 2;
-  rate[0] += sse_mat(0, 0) / 2;
-  chol_diag[0] = sqrt(gamma_rand(shape[0], 1 / rate[0], rng)); // psi[11]^2 ~ Gamma(shape, rate)
-  int block_id = 0;
-  for (int j = 1; j < dim; j++) {
-    sse_colvec.segment(0, j) = sse_mat.block(0, j, j, 1); // (s1j, ..., sj-1,j)
-    rate[j] += (
-      sse_mat(j, j) - 
-        sse_colvec.segment(0, j).transpose() * 
-        (sse_mat.topLeftCorner(j, j) + inv_DRD.block(block_id, block_id, j, j)).llt().solve(Eigen::MatrixXd::Identity(j, j)) * 
-        sse_colvec.segment(0, j)
-    ) / 2;
-    chol_diag[j] = sqrt(gamma_rand(shape[j], 1 / rate[j], rng)); // psi[jj]^2 ~ Gamma(shape, rate)
-    block_id += j;
+// Building Factor Loading Matrix
+//
+// In factor SV, this function builds k x q \eqn{\Lambda} given its free elements.
+// The first q rows are lower triangular with unit diagonal for identification,
+// and the free elements are stacked row-wise as \eqn{a} in `build_inv_lower()`.
+//
+// @param dim Number of variables k
+// @param num_factor Number of factors q
+// @param loading_vec Free elements of \eqn{\Lambda}
+inline Eigen::MatrixXd build_factor_loading(int dim, int num_factor, const Eigen::VectorXd& loading_vec) {
+  Eigen::MatrixXd res = Eigen::MatrixXd::Identity(dim, num_factor);
+  int id = 0;
+  for (int i = 1; i < dim; i++) {
+    int num_free = std::min(i, num_factor);
+    res.row(i).head(num_free) = loading_vec.segment(id, num_free);
+    id += num_free;
   }
+  return res;
 }
 
-// Generating the Off-Diagonal Component of Cholesky Factor in SSVS Gibbs Sampler
+// Generating the Cholesky Factor of Precision Matrix in SSVS Gibbs Sampler
 // 
-// In MCMC process of SSVS, this function generates the off-diagonal component \eqn{\Psi} of variance matrix
+// In MCMC process of SSVS, this function generates the diagonal component \eqn{\psi_{jj}} and then the off-diagonal component \eqn{\eta_j} of each column of \eqn{\Psi}.
+// Both draws of the column use one factorization \eqn{S_{j - 1} + D_j^{-2} = L L^T} of the leading block,
+// with \eqn{s_j^T (S_{j - 1} + D_j^{-2})^{-1} s_j = \lVert L^{-1} s_j \rVert^2} and \eqn{\eta_j = L^{-T} (z - \psi_{jj} L^{-1} s_j)}.
 // 
-// @param sse_mat The result of \eqn{Z_0^T Z_0 = (Y_0 - X_0 \hat{A})^T (Y_0 - X_0 \hat{A})}
 // @param chol_diag Diagonal element of the cholesky factor
-// @param DRD Inverse of matrix product between \eqn{D_j} and correlation matrix \eqn{R_j}
-inline void ssvs_chol_off(Eigen::VectorXd& chol_off, Eigen::MatrixXd& sse_mat,
-													Eigen::VectorXd& chol_diag, Eigen::VectorXd& DRD, boost::random::mt19937& rng) {
+// @param chol_off Off-diagonal element of the cholesky factor
+// @param sse_mat The result of \eqn{Z_0^T Z_0 = (Y_0 - X_0 \hat{A})^T (Y_0 - X_0 \hat{A})}
+// @param chol_sd Spike-and-slab sd of each off-diagonal element
+// @param shape Gamma shape parameters for precision matrix
+// @param rate Gamma rate parameters for precision matrix
+// @param num_design The number of sample used, \eqn{n = T - p}
+inline void ssvs_chol(Eigen::VectorXd& chol_diag, Eigen::VectorXd& chol_off, const Eigen::MatrixXd& sse_mat, const Eigen::VectorXd& chol_sd,
+											const Eigen::VectorXd& shape, const Eigen::VectorXd& rate, int num_design, boost::random::mt19937& rng) {
 	int dim = sse_mat.cols();
-  int num_param = DRD.size();
-  Eigen::MatrixXd normal_variance(dim - 1, dim - 1);
-  Eigen::VectorXd sse_colvec(dim - 1); // sj = (s1j, ..., s(j-1, j)) from SSE
-  Eigen::VectorXd normal_mean(dim - 1);
-  // Eigen::VectorXd res(num_param);
-  Eigen::MatrixXd inv_DRD = Eigen::MatrixXd::Zero(num_param, num_param);
-  inv_DRD.diagonal() = 1 / DRD.array().square();
-  int block_id = 0;
-  for (int j = 1; j < dim; j++) {
-    sse_colvec.segment(0, j) = sse_mat.block(0, j, j, 1);
-    normal_variance.topLeftCorner(j, j) = (sse_mat.topLeftCorner(j, j) + inv_DRD.block(block_id, block_id, j, j)).llt().solve(Eigen::MatrixXd::Identity(j, j));
-    normal_mean.segment(0, j) = -chol_diag[j] * normal_variance.topLeftCorner(j, j) * sse_colvec.segment(0, j);
-    chol_off.segment(block_id, j) = vectorize_eigen(sim_mgaussian_chol(1, normal_mean.segment(0, j), normal_variance.topLeftCorner(j, j), rng));
-    block_id += j;
-  }
+	double shape_add = static_cast<double>(num_design) / 2;
+	chol_diag[0] = sqrt(gamma_rand(shape[0] + shape_add, 1 / (rate[0] + sse_mat(0, 0) / 2), rng)); // psi[11]^2 ~ Gamma(shape, rate)
+	Eigen::LLT<Eigen::MatrixXd> llt_block;
+	int block_id = 0;
+	for (int j = 1; j < dim; j++) {
+		Eigen::MatrixXd block_prec = sse_mat.topLeftCorner(j, j);
+		block_prec.diagonal().array() += chol_sd.segment(block_id, j).array().square().inverse();
+		llt_block.compute(block_prec);
+		Eigen::VectorXd half_sse = llt_block.matrixL().solve(sse_mat.col(j).head(j)); // L^(-1) sj with sj = (s1j, ..., s(j-1, j))
+		chol_diag[j] = sqrt(gamma_rand(
+			shape[j] + shape_add,
+			1 / (rate[j] + (sse_mat(j, j) - half_sse.squaredNorm()) / 2),
+			rng
+		)); // psi[jj]^2 ~ Gamma(shape, rate)
+		Eigen::VectorXd standard_normal(j);
+		for (int i = 0; i < j; i++) {
+			standard_normal[i] = normal_rand(rng);
+		}
+		chol_off.segment(block_id, j) = llt_block.matrixU().solve(standard_normal - chol_diag[j] * half_sse); // eta_j ~ N(-psi[jj] (S + D^(-2))^(-1) sj, (S + D^(-2))^(-1))
+		block_id += j;
+	}
 }
 
 // Filling Cholesky Factor Upper Triangular Matrix
@@ -269,23 +271,140 @@ inline void ssvs_mn_weight(Eigen::VectorXd& weight, Eigen::VectorXi& grp_vec, Ei
 // Generating the Equation-wise Coefficients Vector and Contemporaneous Coefficients
 // 
 // This function generates j-th column of coefficients matrix and j-th row of impact matrix using precision sampler.
+// MaxDim bounds the number of coefficients at compile time,
+// so that small regressions such as the rows of L keep the posterior precision and its factor on the stack.
 //
 // @param x Design matrix of the system
 // @param y Response vector of the system
 // @param prior_mean Prior mean vector
 // @param prior_prec Prior precision matrix
 // @param innov_prec Stacked precision matrix of innovation
+template <int MaxDim = Eigen::Dynamic>
 inline void varsv_regression(Eigen::Ref<Eigen::VectorXd> coef, Eigen::MatrixXd& x, Eigen::VectorXd& y,
-														 Eigen::VectorXd prior_mean, Eigen::MatrixXd prior_prec, boost::random::mt19937& rng) {
+														 const Eigen::Ref<const Eigen::VectorXd>& prior_mean, const Eigen::Ref<const Eigen::MatrixXd>& prior_prec,
+														 boost::random::mt19937& rng) {
+	using VecType = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, MaxDim, 1>;
+	using MatType = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor, MaxDim, MaxDim>;
   int dim = prior_mean.size();
-  Eigen::VectorXd res(dim);
+  VecType res(dim);
   for (int i = 0; i < dim; i++) {
 		res[i] = normal_rand(rng);
   }
-  Eigen::MatrixXd post_sig = prior_prec + x.transpose() * x;
-  Eigen::LLT<Eigen::MatrixXd> lltOfscale(post_sig);
-  Eigen::VectorXd post_mean = lltOfscale.solve(prior_prec * prior_mean + x.transpose() * y);
-	coef = post_mean + lltOfscale.matrixU().solve(res);
+  MatType post_sig = prior_prec;
+	post_sig.noalias() += x.transpose() * x;
+  Eigen::LLT<MatType> lltOfscale(post_sig);
+	VecType post_mean = prior_prec * prior_mean;
+	post_mean.noalias() += x.transpose() * y;
+	lltOfscale.solveInPlace(post_mean);
+	lltOfscale.matrixU().solveInPlace(res);
+	coef = post_mean + res;
+}
+
+// Auxiliary Mixture Indicators of Log-Volatilities
+// 
+// Time points are processed in blocks of 64 held in a fixed-size 64 x 7 array, one column per component.
+// Each step (log-weight, shift by the maximum, exp, cumulative sum, and comparison with the uniform)
+// is a column operation over contiguous time points, so Eigen vectorizes it with whatever packet size
+// the build supports, and falls back to scalar code otherwise. No n x 7 matrix is allocated.
+// Weights are shifted by their maximum before exponentiating, so the selection does not underflow.
+// One uniform is drawn per time point in order, as in the scalar inverse transform.
+// 
+// @param mixture_id Selected component (0 to 6) of each time point
+// @param ls_resid log(y^2) - h of each time point
+// @param log_pj Log of mixture probabilities minus log of standard deviations
+// @param muj Mixture means
+// @param inv_sigj Inverse of mixture variances
+inline void varsv_mixture(Eigen::VectorXi& mixture_id, const Eigen::VectorXd& ls_resid,
+													const Eigen::Array<double, 7, 1>& log_pj, const Eigen::Array<double, 7, 1>& muj,
+													const Eigen::Array<double, 7, 1>& inv_sigj, boost::random::mt19937& rng) {
+	constexpr int block_size = 64;
+	Eigen::Array<double, block_size, 7> mixture_wt; // log-weights, then cumulative weights
+	Eigen::Array<double, block_size, 1> max_wt;
+	Eigen::Array<double, block_size, 1> inv_method;
+	Eigen::Array<int, block_size, 1> block_id;
+	int num_design = ls_resid.size();
+	for (int start = 0; start < num_design; start += block_size) {
+		int len = std::min(block_size, num_design - start);
+		auto resid = ls_resid.segment(start, len).array();
+		for (int j = 0; j < 7; j++) {
+			mixture_wt.col(j).head(len) = log_pj[j] - (resid - muj[j]).square() * (inv_sigj[j] / 2); // log-weight up to constant
+		}
+		max_wt.head(len) = mixture_wt.col(0).head(len);
+		for (int j = 1; j < 7; j++) {
+			max_wt.head(len) = max_wt.head(len).max(mixture_wt.col(j).head(len));
+		}
+		mixture_wt.col(0).head(len) = (mixture_wt.col(0).head(len) - max_wt.head(len)).exp();
+		for (int j = 1; j < 7; j++) {
+			mixture_wt.col(j).head(len) = mixture_wt.col(j - 1).head(len) + (mixture_wt.col(j).head(len) - max_wt.head(len)).exp(); // unnormalized cumulative sum
+		}
+		for (int t = 0; t < len; t++) {
+			inv_method[t] = unif_rand(0, 1, rng) * mixture_wt(t, 6);
+		}
+		block_id.head(len).setZero();
+		for (int j = 0; j < 6; j++) {
+			block_id.head(len) += (mixture_wt.col(j).head(len) <= inv_method.head(len)).cast<int>(); // first component whose cumulative weight exceeds the uniform
+		}
+		mixture_id.segment(start, len) = block_id.head(len).matrix();
+	}
+}
+
+// Generating log-volatilities of Lockstep Chains in MCMC
+// 
+// In MCMC, this function samples log-volatilities \eqn{h_{it}} vectors of several chains using auxiliary mixture sampling.
+// The posterior precision \eqn{H^T H / \sigma_h^2 + diag(1 / \sigma_{s_t}^2)} is tridiagonal,
+// so its Cholesky factor is bidiagonal and each draw costs O(n) instead of the dense O(n^3).
+// Chains are laid out in the rows of C x n arrays, and every recursion step works on the C chains at once.
+// Each chain draws its mixture indicators and then its standard normals from its own RNG,
+// so a chain gets the same draws whether it runs alone or in lockstep.
+// 
+// @param sv_mat log-volatilities vector of each chain: n x C
+// @param init_sv Initial log-volatility of each chain
+// @param sv_sig Variance of log-volatilities of each chain
+// @param latent_mat Auxiliary residual vector of each chain: n x C
+// @param rng RNG of each chain
+inline void varsv_ht_lockstep(Eigen::Ref<Eigen::MatrixXd> sv_mat, const Eigen::VectorXd& init_sv, const Eigen::VectorXd& sv_sig,
+															const Eigen::Ref<const Eigen::MatrixXd>& latent_mat, const std::vector<boost::random::mt19937*>& rng) {
+  int num_design = sv_mat.rows(); // h_i1, ..., h_in for i = 1, .., k
+	int num_chains = sv_mat.cols();
+  // 7-component normal mixutre
+  Eigen::Array<double, 7, 1> pj; // p_t
+  pj << 0.0073, 0.10556, 0.00002, 0.04395, 0.34001, 0.24566, 0.2575;
+  Eigen::Array<double, 7, 1> muj; // mu_t
+  muj << -10.12999, -3.97281, -8.56686, 2.77786, 0.61942, 1.79518, -1.08819;
+  muj -= 1.2704;
+  Eigen::Array<double, 7, 1> sigj; // sig_t^2
+  sigj << 5.79596, 2.61369, 5.17950, 0.16735, 0.64009, 0.34023, 1.26261;
+  Eigen::VectorXi binom_latent(num_design);
+	Eigen::ArrayXXd prec_s(num_chains, num_design); // 1 / sig_st^2
+	Eigen::ArrayXXd post_resp(num_chains, num_design); // H^T H 1 h0 / sig_h^2 + (y_t^* - mu_st) / sig_st^2
+	Eigen::ArrayXXd std_norm(num_chains, num_design);
+	for (int chain = 0; chain < num_chains; chain++) {
+		varsv_mixture(binom_latent, latent_mat.col(chain) - sv_mat.col(chain), pj.log() - sigj.log() / 2, muj, sigj.inverse(), *rng[chain]); // 0 to 6 for indexing
+		for (int t = 0; t < num_design; t++) {
+			prec_s(chain, t) = 1 / sigj[binom_latent[t]];
+			post_resp(chain, t) = (latent_mat(t, chain) - muj[binom_latent[t]]) * prec_s(chain, t);
+		}
+		for (int t = 0; t < num_design; t++) {
+			std_norm(chain, t) = normal_rand(*rng[chain]);
+		}
+	}
+	Eigen::ArrayXd prec_h = sv_sig.array().inverse(); // H^T H has 2 (1 at t = n) on the diagonal and -1 off the diagonal
+	post_resp.col(0) += init_sv.array() * prec_h; // H^T H 1 = (1, 0, ..., 0)
+	Eigen::ArrayXXd chol_diag(num_chains, num_design); // diagonal of the bidiagonal factor
+	Eigen::ArrayXXd chol_off(num_chains, num_design); // sub-diagonal of the factor at (t, t - 1)
+	chol_diag.col(0) = ((num_design > 1 ? 2 : 1) * prec_h + prec_s.col(0)).sqrt();
+	post_resp.col(0) /= chol_diag.col(0);
+	for (int t = 1; t < num_design; t++) {
+		chol_off.col(t) = -prec_h / chol_diag.col(t - 1);
+		chol_diag.col(t) = ((t < num_design - 1 ? 2 : 1) * prec_h + prec_s.col(t) - chol_off.col(t).square()).sqrt();
+		post_resp.col(t) = (post_resp.col(t) - chol_off.col(t) * post_resp.col(t - 1)) / chol_diag.col(t); // L^(-1) b
+	}
+	post_resp += std_norm; // h = L^(-T) (L^(-1) b + z)
+	post_resp.col(num_design - 1) /= chol_diag.col(num_design - 1);
+	for (int t = num_design - 2; t >= 0; t--) {
+		post_resp.col(t) = (post_resp.col(t) - chol_off.col(t + 1) * post_resp.col(t + 1)) / chol_diag.col(t);
+	}
+	sv_mat = post_resp.matrix().transpose();
 }
 
 // Generating log-volatilities in MCMC
@@ -298,52 +417,8 @@ inline void varsv_regression(Eigen::Ref<Eigen::VectorXd> coef, Eigen::MatrixXd&
 // @param latent_vec Auxiliary residual vector
 inline void varsv_ht(Eigen::Ref<Eigen::VectorXd> sv_vec, double init_sv,
 										 double sv_sig, Eigen::Ref<Eigen::VectorXd> latent_vec, boost::random::mt19937& rng) {
-  int num_design = sv_vec.size(); // h_i1, ..., h_in for i = 1, .., k
-  // 7-component normal mixutre
-  Eigen::VectorXd pj(7); // p_t
-  pj << 0.0073, 0.10556, 0.00002, 0.04395, 0.34001, 0.24566, 0.2575;
-  Eigen::VectorXd muj(7); // mu_t
-  muj << -10.12999, -3.97281, -8.56686, 2.77786, 0.61942, 1.79518, -1.08819;
-  muj.array() -= 1.2704;
-  Eigen::VectorXd sigj(7); // sig_t^2
-  sigj << 5.79596, 2.61369, 5.17950, 0.16735, 0.64009, 0.34023, 1.26261;
-  Eigen::VectorXd sdj = sigj.cwiseSqrt();
-  Eigen::VectorXi binom_latent(num_design);
-  Eigen::VectorXd ds(num_design); // (mu_st - 1.2704)
-  Eigen::MatrixXd inv_sig_s = Eigen::MatrixXd::Zero(num_design, num_design); // diag(1 / sig_st^2)
-  Eigen::VectorXd inv_method(num_design); // inverse transform method
-  Eigen::MatrixXd mixture_pdf(num_design, 7);
-  Eigen::MatrixXd mixture_cumsum = Eigen::MatrixXd::Zero(num_design, 7);
-  for (int i = 0; i < num_design; i++) {
-		inv_method[i] = unif_rand(0, 1, rng);
-  }
-  for (int i = 0; i < 7; i++) {
-    mixture_pdf.col(i) = (-((latent_vec.array() - sv_vec.array() - muj[i]).array() / sdj[i]).array().square() / 2).exp() * pj[i] / (sdj[i] * sqrt(2 * M_PI));
-  }
-  mixture_pdf.array().colwise() /= mixture_pdf.rowwise().sum().array();
-  for (int i = 0; i < 7; i++) {
-    mixture_cumsum.block(0, i, num_design, 7 - i) += mixture_pdf.col(i).rowwise().replicate(7 - i);
-  }
-  binom_latent.array() = 7 - (inv_method.rowwise().replicate(7).array() < mixture_cumsum.array()).cast<int>().rowwise().sum().array(); // 0 to 6 for indexing
-  Eigen::MatrixXd diff_mat = Eigen::MatrixXd::Identity(num_design, num_design);
-  for (int i = 0; i < num_design - 1; i++) {
-    ds[i] = muj[binom_latent[i]];
-    inv_sig_s(i, i) = 1 / sigj[binom_latent[i]];
-    diff_mat(i + 1, i) = -1;
-  }
-  ds[num_design - 1] = muj[binom_latent[num_design - 1]];
-  inv_sig_s(num_design - 1, num_design - 1) = 1 / sigj[binom_latent[num_design - 1]];
-  Eigen::MatrixXd HtH = diff_mat.transpose() * diff_mat;
-  Eigen::VectorXd res(num_design);
-  for (int i = 0; i < num_design; i++) {
-		res[i] = normal_rand(rng);
-  }
-  Eigen::MatrixXd post_sig = HtH / sv_sig + inv_sig_s;
-  Eigen::LLT<Eigen::MatrixXd> lltOfscale(post_sig);
-  Eigen::VectorXd post_mean = lltOfscale.solve(
-    HtH * init_sv * Eigen::VectorXd::Ones(num_design) / sv_sig + inv_sig_s * (latent_vec - ds)
-  );
-	sv_vec = post_mean + lltOfscale.matrixU().solve(res);
+	std::vector<boost::random::mt19937*> chain_rng{&rng};
+	varsv_ht_lockstep(sv_vec, Eigen::VectorXd::Constant(1, init_sv), Eigen::VectorXd::Constant(1, sv_sig), latent_vec, chain_rng);
 }
 
 // Generating sig_h in MCMC
@@ -414,7 +489,7 @@ inline void build_shrink_mat(Eigen::MatrixXd& cov, Eigen::VectorXd& global_hyper
 // @param response_vec Response vector for vectorized formulation
 // @param design_mat Design matrix for vectorized formulation
 // @param shrink_mat Diagonal matrix made by global and local sparsity hyperparameters
-inline void horseshoe_coef(Eigen::VectorXd& coef, Eigen::VectorXd& response_vec, Eigen::MatrixXd& design_mat,
+inline void horseshoe_coef(Eigen::VectorXd& coef, const Eigen::VectorXd& response_vec, const Eigen::MatrixXd& design_mat,
                     			 double var, Eigen::MatrixXd& shrink_mat, boost::random::mt19937& rng) {
 	int dim = coef.size();
 	Eigen::VectorXd res(dim);
@@ -455,7 +530,7 @@ inline void horseshoe_fast_coef(Eigen::VectorXd& coef, Eigen::VectorXd response_
 // @param response_vec Response vector for vectorized formulation
 // @param design_mat Design matrix for vectorized formulation
 // @param shrink_mat Diagonal matrix made by global and local sparsity hyperparameters
-inline void horseshoe_coef_var(Eigen::VectorXd& coef_var, Eigen::VectorXd& response_vec, Eigen::MatrixXd& design_mat,
+inline void horseshoe_coef_var(Eigen::VectorXd& coef_var, const Eigen::VectorXd& response_vec, const Eigen::MatrixXd& design_mat,
 															 Eigen::MatrixXd& shrink_mat, boost::random::mt19937& rng) {
   int dim = design_mat.cols();
   int sample_size = response_vec.size();
@@ -477,7 +552,7 @@ inline void horseshoe_coef_var(Eigen::VectorXd& coef_var, Eigen::VectorXd& respo
 // @param design_mat Design matrix for vectorized formulation
 // @param coef_vec Coefficients vector
 // @param shrink_mat Diagonal matrix made by global and local sparsity hyperparameters
-inline double horseshoe_var(Eigen::VectorXd& response_vec, Eigen::MatrixXd& design_mat, Eigen::MatrixXd& shrink_mat, boost::random::mt19937& rng) {
+inline double horseshoe_var(const Eigen::VectorXd& response_vec, const Eigen::MatrixXd& design_mat, Eigen::MatrixXd& shrink_mat, boost::random::mt19937& rng) {
   int sample_size = response_vec.size();
   double scl = response_vec.transpose() * (Eigen::MatrixXd::Identity(sample_size, sample_size) - design_mat * shrink_mat * design_mat.transpose()) * response_vec;
   scl *= .5;
@@ -572,21 +647,6 @@ inline void horseshoe_latent(Eigen::VectorXd& latent, Eigen::VectorXd& hyperpara
   }
 }
 
-template<typename Derived>
-inline Eigen::Matrix<typename Derived::Scalar, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime, Derived::Options> thin_record(const Eigen::MatrixBase<Derived>& record, int num_iter, int num_burn, int thin) {
-  if (thin == 1) {
-    return record.bottomRows(num_iter - num_burn);
-  }
-  Eigen::Matrix<typename Derived::Scalar, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime, Derived::Options> col_record(record.bottomRows(num_iter - num_burn));
-  int num_res = (num_iter - num_burn + thin - 1) / thin; // nrow after thinning
-  Eigen::Map<const Eigen::Matrix<typename Derived::Scalar, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime, Derived::Options>, 0, Eigen::InnerStride<>> res(
-    col_record.data(),
-    num_res, record.cols(),
-    Eigen::InnerStride<>(thin * col_record.innerStride())
-  );
-  return res;
-}
-
 } // namespace bvhar
 
 #endif // BVHARDRAW_H
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef BVHARFIXED_H
+#define BVHARFIXED_H
+
+#include <RcppEigen.h>
+#include <utility>
+
+namespace bvhar {
+
+// Largest dimension with fixed-size kernels
+//
+// Above this, k x k blocks are large enough that heap allocation does not matter next to the arithmetic.
+constexpr int max_fixed_dim = 8;
+
+// Compile-time Dimension Dispatch
+//
+// Kernel<Dim>::run() is written once with Eigen::Matrix<double, Dim, Dim>-type temporaries.
+// For k = 2, ..., 8, Dim is the fixed k, so the temporaries live on the stack and k x k products and factorizations are unrolled.
+// Other k run the same code with Dim = Eigen::Dynamic.
+//
+// @param dim Number of variables k
+// @param args Arguments passed to Kernel<Dim>::run()
+template <template <int> class Kernel, typename... Args>
+inline void dispatch_dim(int dim, Args&&... args) {
+	switch (dim) {
+	case 2:
+		Kernel<2>::run(std::forward<Args>(args)...);
+		break;
+	case 3:
+		Kernel<3>::run(std::forward<Args>(args)...);
+		break;
+	case 4:
+		Kernel<4>::run(std::forward<Args>(args)...);
+		break;
+	case 5:
+		Kernel<5>::run(std::forward<Args>(args)...);
+		break;
+	case 6:
+		Kernel<6>::run(std::forward<Args>(args)...);
+		break;
+	case 7:
+		Kernel<7>::run(std::forward<Args>(args)...);
+		break;
+	case 8:
+		Kernel<8>::run(std::forward<Args>(args)...);
+		break;
+	default:
+		Kernel<Eigen::Dynamic>::run(std::forward<Args>(args)...);
+	}
+}
+
+} // namespace bvhar
+
+#endif // BVHARFIXED_H
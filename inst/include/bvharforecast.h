@@ -0,0 +1,78 @@
+#ifndef BVHARFORECAST_H
+#define BVHARFORECAST_H
+
+#include "bvhardraw.h"
+#include "bvharfixed.h"
+
+namespace bvhar {
+
+// Predictive Distribution of VAR-SV and VHAR-SV
+//
+// For each posterior draw, the lag state moves forward step times with
+// \eqn{h_{T + 1} \sim N(h_T, diag(1 / \sigma_h^2))} and \eqn{y_{T + i} \sim N(\hat{y}_{T + i}, (L^T D_{T + 1}^{-1} L)^{-1})}.
+// Run through dispatch_dim(), so the k-dim vectors and k x k matrices of each step are fixed-size for small k.
+//
+// @param predictive_distn Result: rbind(chains), cbind(sims)
+// @param lag_init VarLag or VharLag at the end of the data
+// @param num_chains Number of MCMC chains
+// @param step Integer, Step to forecast
+// @param coef_record MCMC record of coefficients, with constant term in the last k columns
+// @param h_last_record MCMC record of log-volatilities in last time
+// @param a_record MCMC record of contemporaneous coefficients
+// @param sigh_record MCMC record of variance of log-volatilities
+// @param include_mean Constant term
+template <int Dim>
+struct SvDensityForecast {
+	template <typename LagState>
+	static void run(Eigen::MatrixXd& predictive_distn, const LagState& lag_init, int num_chains, int step,
+									const Eigen::MatrixXd& coef_record, const Eigen::MatrixXd& h_last_record,
+									const Eigen::MatrixXd& a_record, const Eigen::MatrixXd& sigh_record, bool include_mean) {
+		using VecType = Eigen::Matrix<double, Dim, 1>;
+		using RowType = Eigen::Matrix<double, 1, Dim>;
+		using MatType = Eigen::Matrix<double, Dim, Dim>;
+		int dim = h_last_record.cols();
+		int num_sim = coef_record.rows() / num_chains;
+		int num_alpha = include_mean ? coef_record.cols() - dim : coef_record.cols();
+		int dim_alpha = num_alpha / dim;
+		Eigen::Matrix<double, Eigen::Dynamic, Dim> coef_mat(coef_record.cols() / dim, dim); // include constant term
+		VecType sv_sd(dim);
+		VecType sv_update(dim);
+		RowType density_forecast(dim);
+		RowType standard_normal(dim);
+		MatType contem_mat(dim, dim);
+		MatType tvp_prec(dim, dim);
+		MatType tvp_sig(dim, dim);
+		for (int chain = 0; chain < num_chains; chain++) {
+			for (int b = 0; b < num_sim; b++) {
+				int draw_id = chain * num_sim + b;
+				LagState lag_state(lag_init); // each draw has its own recursion
+				for (int j = 0; j < dim; j++) {
+					coef_mat.col(j).head(dim_alpha) = coef_record.row(draw_id).segment(j * dim_alpha, dim_alpha).transpose();
+				}
+				if (include_mean) {
+					coef_mat.bottomRows(1) = coef_record.row(draw_id).tail(dim);
+				}
+				sv_sd = (1 / sigh_record.row(draw_id).array()).sqrt().matrix().transpose(); // covariance of h_t is diag(1 / sigh)
+				contem_mat = build_inv_lower<Dim>(dim, a_record.row(draw_id));
+				for (int i = 0; i < step; i++) {
+					lag_state.multiply(coef_mat, density_forecast);
+					for (int j = 0; j < dim; j++) {
+						standard_normal[j] = norm_rand();
+					}
+					sv_update = h_last_record.row(draw_id).transpose() + sv_sd.cwiseProduct(standard_normal.transpose()); // h_T+1 = h_T + u_T
+					tvp_prec.noalias() = contem_mat.transpose() * (1 / sv_update.array().exp()).matrix().asDiagonal() * contem_mat; // L^T D_T^(-1) L
+					tvp_sig = tvp_prec.inverse();
+					for (int j = 0; j < dim; j++) {
+						standard_normal[j] = norm_rand();
+					}
+					predictive_distn.block(chain * step + i, b * dim, 1, dim) = standard_normal * tvp_sig.llt().matrixU() + density_forecast;
+					lag_state.update(density_forecast.transpose());
+				}
+			}
+		}
+	}
+};
+
+} // namespace bvhar
+
+#endif // BVHARFORECAST_H
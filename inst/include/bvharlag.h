@@ -0,0 +1,212 @@
+#ifndef BVHARLAG_H
+#define BVHARLAG_H
+
+#include <RcppEigen.h>
+#include <vector>
+
+namespace bvhar {
+
+// Lagged State of VAR Recursion
+//
+// Keeps the last p observations in a ring buffer instead of shifting [y(t), ..., y(t - p + 1), 1].
+// multiply() reads the lags in circular order, so each update only overwrites the oldest slot.
+class VarLag {
+public:
+	VarLag(const Eigen::MatrixXd& y, int lag, bool include_mean)
+	: dim(y.cols()), lag(lag), include_mean(include_mean),
+		lag_buffer(y.bottomRows(lag).transpose()), newest(lag - 1) {}
+	virtual ~VarLag() = default;
+	// [y(t)^T, ..., y(t - p + 1)^T, (1)] %*% coef
+	template <typename Derived>
+	Eigen::RowVectorXd multiply(const Eigen::MatrixBase<Derived>& coef) const {
+		Eigen::RowVectorXd res = include_mean ? Eigen::RowVectorXd(coef.row(lag * dim)) : Eigen::RowVectorXd::Zero(coef.cols());
+		for (int i = 0; i < lag; i++) {
+			res.noalias() += lag_buffer.col((newest - i + lag) % lag).transpose() * coef.middleRows(i * dim, dim);
+		}
+		return res;
+	}
+	// Same product written into a preallocated row, which can be fixed-size
+	template <typename Derived, typename ResDerived>
+	void multiply(const Eigen::MatrixBase<Derived>& coef, Eigen::MatrixBase<ResDerived>& res) const {
+		if (include_mean) {
+			res = coef.row(lag * dim);
+		} else {
+			res.setZero();
+		}
+		for (int i = 0; i < lag; i++) {
+			res.noalias() += lag_buffer.col((newest - i + lag) % lag).transpose() * coef.middleRows(i * dim, dim);
+		}
+	}
+	// [y(t)^T, ..., y(t - p + 1)^T, (1)]^T
+	Eigen::VectorXd getLag() const {
+		Eigen::VectorXd res = Eigen::VectorXd::Ones(lag * dim + (include_mean ? 1 : 0));
+		for (int i = 0; i < lag; i++) {
+			res.segment(i * dim, dim) = lag_buffer.col((newest - i + lag) % lag);
+		}
+		return res;
+	}
+	template <typename Derived>
+	void update(const Eigen::MatrixBase<Derived>& new_obs) {
+		newest = (newest + 1) % lag;
+		lag_buffer.col(newest) = new_obs; // overwrite y(t - p + 1)
+	}
+private:
+	int dim;
+	int lag;
+	bool include_mean;
+	Eigen::MatrixXd lag_buffer; // m x p ring buffer of the last p observations
+	int newest; // column of the latest observation
+};
+
+// Lagged State of VHAR Recursion
+//
+// Keeps the last `month` observations in a ring buffer together with the running sum of each HAR order.
+// HAR regressor [daily, weekly, monthly, (1)] is then available without X0 or HARtrans,
+// and each update costs O(k) per HAR term instead of shifting the (month - 1)k buffer.
+class VharLag {
+public:
+	VharLag(const Eigen::MatrixXd& y, const Eigen::VectorXi& har_order, bool include_mean)
+	: dim(y.cols()), month(har_order.maxCoeff()), num_har(har_order.size()), har_order(har_order),
+		lag_buffer(y.bottomRows(month)), newest(month - 1),
+		run_sum(Eigen::MatrixXd::Zero(num_har, dim)),
+		har_vec(Eigen::VectorXd::Ones(num_har * dim + (include_mean ? 1 : 0))) {
+		for (int j = 0; j < num_har; j++) {
+			run_sum.row(j) = lag_buffer.bottomRows(har_order[j]).colwise().sum();
+		}
+		updateHar();
+	}
+	VharLag(const Eigen::MatrixXd& y, int week, int month, bool include_mean)
+	: VharLag(y, (Eigen::VectorXi(3) << 1, week, month).finished(), include_mean) {}
+	// HAR orders are recovered from rows of [daily, weekly, monthly] in HARtrans,
+	// and the constant term from its extra row (3k + 1 rows), which also holds when k = 1.
+	VharLag(const Eigen::MatrixXd& y, const Eigen::MatrixXd& har_trans)
+	: VharLag(y, har_order_of(har_trans, y.cols()), har_trans.rows() == 3 * y.cols() + 1) {}
+	virtual ~VharLag() = default;
+	const Eigen::VectorXd& getHar() const {
+		return har_vec;
+	}
+	// [daily, weekly, monthly, (1)] %*% coef written into a preallocated row
+	template <typename Derived, typename ResDerived>
+	void multiply(const Eigen::MatrixBase<Derived>& coef, Eigen::MatrixBase<ResDerived>& res) const {
+		res.noalias() = har_vec.transpose() * coef;
+	}
+	template <typename Derived>
+	void update(const Eigen::MatrixBase<Derived>& new_obs) {
+		for (int j = 0; j < num_har; j++) {
+			run_sum.row(j) += new_obs.transpose() - lag_buffer.row((newest - har_order[j] + 1 + month) % month); // drop y(t - order)
+		}
+		newest = (newest + 1) % month;
+		lag_buffer.row(newest) = new_obs; // overwrite y(t - month)
+		updateHar();
+	}
+private:
+	int dim;
+	int month;
+	int num_har;
+	Eigen::VectorXi har_order;
+	Eigen::MatrixXd lag_buffer; // ring buffer of the last month observations
+	int newest; // row of the latest observation
+	Eigen::MatrixXd run_sum; // running sum of each HAR order
+	Eigen::VectorXd har_vec; // [daily, weekly, monthly, (1)]
+	void updateHar() {
+		for (int j = 0; j < num_har; j++) {
+			har_vec.segment(j * dim, dim) = run_sum.row(j).transpose() / har_order[j];
+		}
+	}
+	static Eigen::VectorXi har_order_of(const Eigen::MatrixXd& har_trans, int dim) {
+		Eigen::VectorXi res(3);
+		for (int j = 0; j < 3; j++) {
+			res[j] = static_cast<int>(std::round(1 / har_trans(j * dim, 0)));
+		}
+		return res;
+	}
+};
+
+// Check that HARtrans is 3k (+ 1) x (month * k) (+ 1)
+inline void check_har_trans(const Eigen::MatrixXd& har_trans, int dim, int month) {
+	int num_const = har_trans.rows() == 3 * dim + 1 ? 1 : 0;
+	if (har_trans.rows() != 3 * dim + num_const || har_trans.cols() != month * dim + num_const) {
+		Rcpp::stop("'HARtrans' does not match the dimension and 'month'.");
+	}
+}
+
+// Lagged State of Several VAR Paths
+//
+// Same ring buffer as VarLag, but each slot holds one lag of every path as a row,
+// so all paths move forward together by p products of (paths x m) and (m x m).
+class VarPathLag {
+public:
+	VarPathLag(const Eigen::MatrixXd& init, int lag, bool include_mean, int num_path)
+	: dim(init.cols()), lag(lag), include_mean(include_mean), newest(lag - 1),
+		lag_buffer(lag) {
+		for (int i = 0; i < lag; i++) {
+			lag_buffer[i] = init.row(init.rows() - lag + i).replicate(num_path, 1);
+		}
+	}
+	virtual ~VarPathLag() = default;
+	// Each row: [y(t)^T, ..., y(t - p + 1)^T, (1)] %*% coef
+	Eigen::MatrixXd multiply(const Eigen::MatrixXd& coef) const {
+		Eigen::MatrixXd res = include_mean ? Eigen::MatrixXd(coef.row(lag * dim).replicate(lag_buffer[0].rows(), 1)) : Eigen::MatrixXd::Zero(lag_buffer[0].rows(), coef.cols());
+		for (int i = 0; i < lag; i++) {
+			res.noalias() += lag_buffer[(newest - i + lag) % lag] * coef.middleRows(i * dim, dim);
+		}
+		return res;
+	}
+	void update(const Eigen::MatrixXd& new_obs) {
+		newest = (newest + 1) % lag;
+		lag_buffer[newest] = new_obs;
+	}
+private:
+	int dim;
+	int lag;
+	bool include_mean;
+	int newest;
+	std::vector<Eigen::MatrixXd> lag_buffer; // paths x m block of each lag
+};
+
+// Lagged State of Several VHAR Paths
+//
+// Running sums of VharLag kept for every path as (paths x m) blocks.
+class VharPathLag {
+public:
+	VharPathLag(const Eigen::MatrixXd& init, int week, int month, bool include_mean, int num_path)
+	: dim(init.cols()), month(month), include_mean(include_mean), har_order((Eigen::VectorXi(3) << 1, week, month).finished()),
+		newest(month - 1), lag_buffer(month), run_sum(3, Eigen::MatrixXd::Zero(num_path, dim)) {
+		for (int i = 0; i < month; i++) {
+			lag_buffer[i] = init.row(init.rows() - month + i).replicate(num_path, 1);
+		}
+		for (int j = 0; j < 3; j++) {
+			for (int i = month - har_order[j]; i < month; i++) {
+				run_sum[j] += lag_buffer[i];
+			}
+		}
+	}
+	virtual ~VharPathLag() = default;
+	// Each row: [daily, weekly, monthly, (1)] %*% coef
+	Eigen::MatrixXd multiply(const Eigen::MatrixXd& coef) const {
+		Eigen::MatrixXd res = include_mean ? Eigen::MatrixXd(coef.row(3 * dim).replicate(run_sum[0].rows(), 1)) : Eigen::MatrixXd::Zero(run_sum[0].rows(), coef.cols());
+		for (int j = 0; j < 3; j++) {
+			res.noalias() += run_sum[j] * coef.middleRows(j * dim, dim) / har_order[j];
+		}
+		return res;
+	}
+	void update(const Eigen::MatrixXd& new_obs) {
+		for (int j = 0; j < 3; j++) {
+			run_sum[j] += new_obs - lag_buffer[(newest - har_order[j] + 1 + month) % month];
+		}
+		newest = (newest + 1) % month;
+		lag_buffer[newest] = new_obs;
+	}
+private:
+	int dim;
+	int month;
+	bool include_mean;
+	Eigen::VectorXi har_order;
+	int newest;
+	std::vector<Eigen::MatrixXd> lag_buffer; // paths x m block of each of the last month observations
+	std::vector<Eigen::MatrixXd> run_sum; // paths x m running sum of each HAR order
+};
+
+} // namespace bvhar
+
+#endif // BVHARLAG_H
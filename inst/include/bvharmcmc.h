@@ -0,0 +1,264 @@
+#ifndef BVHARMCMC_H
+#define BVHARMCMC_H
+
+#include <RcppEigen.h>
+#include "bvharprogress.h"
+#include "bvharinterrupt.h"
+#include "bvharcheckpoint.h"
+
+namespace bvhar {
+
+// Split-R-hat of Each Parameter
+//
+// Each chain is split into halves, and R-hat is computed over the 2m half chains (Gelman et al. (2013)).
+//
+// @param traces Post burn-in draws of each chain: n x number of parameters
+inline Eigen::VectorXd compute_split_rhat(const std::vector<Eigen::MatrixXd>& traces) {
+	int num_draw = traces[0].rows();
+	int num_half = num_draw / 2; // the middle draw is dropped when n is odd
+	int num_split = 2 * traces.size();
+	Eigen::MatrixXd half_mean(num_split, traces[0].cols());
+	Eigen::MatrixXd half_var(num_split, traces[0].cols());
+	for (int i = 0; i < static_cast<int>(traces.size()); i++) {
+		for (int j = 0; j < 2; j++) {
+			Eigen::MatrixXd half = traces[i].middleRows(j * (num_draw - num_half), num_half);
+			half_mean.row(2 * i + j) = half.colwise().mean();
+			half_var.row(2 * i + j) = (half.rowwise() - half_mean.row(2 * i + j)).colwise().squaredNorm() / (num_half - 1);
+		}
+	}
+	Eigen::ArrayXd within = half_var.colwise().mean().transpose();
+	Eigen::ArrayXd between = (half_mean.rowwise() - half_mean.colwise().mean()).colwise().squaredNorm().transpose() * num_half / (num_split - 1);
+	Eigen::ArrayXd var_plus = (num_half - 1.0) / num_half * within + between / num_half;
+	return (within > 0).select((var_plus / within).sqrt(), 1.0).matrix();
+}
+
+// Batch-means ESS of Each Parameter
+//
+// Each chain is cut into floor(sqrt(n)) batches, and n s^2 / (b var(batch means)) is summed over chains.
+//
+// @param traces Post burn-in draws of each chain: n x number of parameters
+inline Eigen::VectorXd compute_batch_ess(const std::vector<Eigen::MatrixXd>& traces) {
+	Eigen::ArrayXd res = Eigen::ArrayXd::Zero(traces[0].cols());
+	for (const Eigen::MatrixXd& trace : traces) {
+		int batch_size = static_cast<int>(std::floor(std::sqrt(static_cast<double>(trace.rows()))));
+		int num_batch = trace.rows() / batch_size;
+		int num_draw = batch_size * num_batch;
+		Eigen::MatrixXd draws = trace.bottomRows(num_draw);
+		Eigen::RowVectorXd draw_mean = draws.colwise().mean();
+		Eigen::MatrixXd batch_mean(num_batch, draws.cols());
+		for (int i = 0; i < num_batch; i++) {
+			batch_mean.row(i) = draws.middleRows(i * batch_size, batch_size).colwise().mean();
+		}
+		Eigen::ArrayXd batch_var = (batch_mean.rowwise() - draw_mean).colwise().squaredNorm().transpose() * batch_size / (num_batch - 1);
+		Eigen::ArrayXd draw_var = (draws.rowwise() - draw_mean).colwise().squaredNorm().transpose() / (num_draw - 1);
+		res += (batch_var > 0).select(num_draw * draw_var / batch_var, num_draw);
+	}
+	return res.matrix();
+}
+
+// Online Convergence Check of Multi-chain MCMC
+//
+// Every check_every iterations, split-R-hat and batch-means ESS of the chosen coefficients are computed over the retained (post burn-in, thinned) draws of every chain.
+// With stop_early, sampling stops once max R-hat < rhat and min ESS > ess.
+// Empty spec list turns off the check.
+class McmcMonitor {
+public:
+	McmcMonitor(Rcpp::List& spec, int num_iter, int num_burn, int thin, int num_coef)
+	: num_iter(num_iter), num_burn(num_burn), thin(thin), is_active(spec.size() > 0),
+		check_every(num_iter), rhat_target(0), ess_target(0), stop_early(false), is_converged(false), stop_iter(num_iter), num_check(0) {
+		if (is_active) {
+			check_every = spec["check_every"];
+			rhat_target = spec["rhat"];
+			ess_target = spec["ess"];
+			param_id = Rcpp::as<Eigen::VectorXi>(spec["param_id"]);
+			if (param_id.size() > 0 && (param_id.minCoeff() < 0 || param_id.maxCoeff() >= num_coef)) {
+				Rcpp::stop("'param_id' should not exceed the number of coefficients.");
+			}
+			stop_early = spec["stop_early"];
+			int max_check = (num_iter + check_every - 1) / check_every;
+			iter_record = Eigen::VectorXi::Zero(max_check);
+			rhat_record = Eigen::VectorXd::Zero(max_check);
+			ess_record = Eigen::VectorXd::Zero(max_check);
+		}
+	}
+	virtual ~McmcMonitor() = default;
+	bool isActive() const {
+		return is_active;
+	}
+	int nextCheck(int step) const {
+		return std::min((step / check_every + 1) * check_every, num_iter);
+	}
+	// At least two retained draws in each half chain
+	bool isCheckable(int step) const {
+		int num_kept = step > num_burn ? (step - num_burn + thin - 1) / thin : 0;
+		return is_active && (step % check_every == 0 || step == num_iter) && num_kept >= 4;
+	}
+	const Eigen::VectorXi& getParam() const {
+		return param_id;
+	}
+	// Returns true when sampling should stop
+	bool update(int step, const std::vector<Eigen::MatrixXd>& traces) {
+		rhat = compute_split_rhat(traces);
+		ess = compute_batch_ess(traces);
+		iter_record[num_check] = step;
+		rhat_record[num_check] = rhat.maxCoeff();
+		ess_record[num_check] = ess.minCoeff();
+		is_converged = rhat_record[num_check] < rhat_target && ess_record[num_check] > ess_target;
+		num_check++;
+		if (stop_early && is_converged) {
+			stop_iter = step;
+			return true;
+		}
+		return false;
+	}
+	Rcpp::List returnDiagnostic() const {
+		return Rcpp::List::create(
+			Rcpp::Named("iter") = stop_iter,
+			Rcpp::Named("converged") = is_converged,
+			Rcpp::Named("check_iter") = iter_record.head(num_check),
+			Rcpp::Named("max_rhat") = rhat_record.head(num_check),
+			Rcpp::Named("min_ess") = ess_record.head(num_check),
+			Rcpp::Named("rhat") = rhat,
+			Rcpp::Named("ess") = ess
+		);
+	}
+private:
+	int num_iter;
+	int num_burn;
+	int thin;
+	bool is_active;
+	int check_every;
+	double rhat_target;
+	double ess_target;
+	bool stop_early;
+	bool is_converged;
+	int stop_iter; // number of iterations actually run
+	Eigen::VectorXi param_id; // empty: every coefficient
+	int num_check;
+	Eigen::VectorXi iter_record; // iteration of each check
+	Eigen::VectorXd rhat_record; // max R-hat of each check
+	Eigen::VectorXd ess_record; // min ESS of each check
+	Eigen::VectorXd rhat; // R-hat of each parameter at the last check
+	Eigen::VectorXd ess; // ESS of each parameter at the last check
+};
+
+// Lockstep Draws of Chains Sharing One Thread
+//
+// By default, the chains draw in turn. Engines with kernels over chains overload this function.
+template <typename T>
+inline void draw_lockstep(const std::vector<T*>& chains) {
+	for (T* chain : chains) {
+		chain->doPosteriorDraws();
+	}
+}
+
+// Multi-chain Gibbs Sampling
+//
+// Chains run in rounds up to the next convergence check or checkpoint, and threads follow the budget in each round.
+// Without both, every chain runs num_iter iterations in one round as before.
+//
+// Each chain keeps only its retained draws (see McmcRecord), so burn-in and thinning are set in the MCMC objects.
+// When interrupted, the retained draws so far are returned.
+//
+// @param mcmc_objs MCMC object of each chain having doPosteriorDraws(), returnCoefTrace(), returnRecords(), saveState(), and loadState()
+// @param monitor Convergence check
+// @param checkpoint Checkpoint
+// @param budget Thread budget
+// @param num_lockstep Number of chains advanced together by draw_lockstep() in each thread. 1 runs every chain on its own.
+template <typename T>
+inline std::vector<Rcpp::List> run_mcmc_chains(std::vector<std::unique_ptr<T>>& mcmc_objs, McmcMonitor& monitor, const McmcCheckpoint& checkpoint, const ThreadBudget& budget,
+																							 int num_iter, bool display_progress, int num_lockstep = 1) {
+	int num_chains = mcmc_objs.size();
+	std::vector<Rcpp::List> res(num_chains);
+	int step = checkpoint.isResume() ? checkpoint.load(mcmc_objs) : 0;
+	std::vector<std::unique_ptr<bvharprogress>> bars(num_chains);
+	for (int chain = 0; chain < num_chains; chain++) {
+		bars[chain] = std::unique_ptr<bvharprogress>(new bvharprogress(num_iter - step, display_progress));
+	}
+	bvharinterrupt();
+	auto run_gibbs = [&](int chain, int num_step) {
+		for (int i = 0; i < num_step; i++) {
+			if (bvharinterrupt::is_interrupted()) {
+				break;
+			}
+			bars[chain]->increment();
+			if (display_progress) {
+				bars[chain]->update();
+			}
+			mcmc_objs[chain]->doPosteriorDraws();
+		}
+	};
+	int num_block = (num_chains + num_lockstep - 1) / num_lockstep;
+	auto run_lockstep = [&](int block, int num_step) {
+		std::vector<T*> chains;
+		for (int chain = block * num_lockstep; chain < std::min((block + 1) * num_lockstep, num_chains); chain++) {
+			chains.push_back(mcmc_objs[chain].get());
+		}
+		for (int i = 0; i < num_step; i++) {
+			if (bvharinterrupt::is_interrupted()) {
+				break;
+			}
+			for (int chain = block * num_lockstep; chain < std::min((block + 1) * num_lockstep, num_chains); chain++) {
+				bars[chain]->increment();
+				if (display_progress) {
+					bars[chain]->update();
+				}
+			}
+			draw_lockstep(chains);
+		}
+	};
+	while (step < num_iter) {
+		int num_step = std::min(monitor.nextCheck(step), checkpoint.nextSave(step)) - step;
+		if (num_chains == 1) {
+			run_gibbs(0, num_step);
+		} else if (num_lockstep > 1) {
+		#ifdef _OPENMP
+			#pragma omp parallel for num_threads(budget.chainThreads()) schedule(dynamic, 1)
+		#endif
+			for (int block = 0; block < num_block; block++) {
+				run_lockstep(block, num_step);
+			}
+		} else {
+		#ifdef _OPENMP
+			int max_levels = omp_get_max_active_levels();
+			if (budget.isNested()) {
+				omp_set_max_active_levels(2); // intra-chain regions inside the chain-level region
+			}
+			#pragma omp parallel for num_threads(budget.chainThreads()) schedule(dynamic, 1)
+		#endif
+			for (int chain = 0; chain < num_chains; chain++) {
+				run_gibbs(chain, num_step);
+			}
+		#ifdef _OPENMP
+			omp_set_max_active_levels(max_levels);
+		#endif
+		}
+		if (bvharinterrupt::is_interrupted()) {
+			for (int chain = 0; chain < num_chains; chain++) {
+				res[chain] = mcmc_objs[chain]->returnRecords();
+			}
+			return res;
+		}
+		step += num_step;
+		if (monitor.isCheckable(step)) {
+			std::vector<Eigen::MatrixXd> traces(num_chains);
+			for (int chain = 0; chain < num_chains; chain++) {
+				traces[chain] = mcmc_objs[chain]->returnCoefTrace(monitor.getParam());
+			}
+			if (monitor.update(step, traces)) {
+				break;
+			}
+		}
+		if (checkpoint.isSaveStep(step)) {
+			checkpoint.save(mcmc_objs, step);
+		}
+	}
+	for (int chain = 0; chain < num_chains; chain++) {
+		res[chain] = mcmc_objs[chain]->returnRecords();
+	}
+	return res;
+}
+
+} // namespace bvhar
+
+#endif // BVHARMCMC_H
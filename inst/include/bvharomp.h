@@ -16,5 +16,50 @@
 #include <mutex>
 #include <vector> // std::vector in source file
 #include <memory> // std::unique_ptr in source file
+#include <algorithm> // std::min, std::max
+
+namespace bvhar {
+
+// Thread Budget of Multi-chain MCMC
+//
+// Splits nthreads between chains, tasks within each chain, and Eigen.
+// Chains take min(nthreads, num_chains) threads, and the remaining threads are spread over the chains running at once.
+// Eigen runs serially inside of a parallel region, so it gets every thread only with a single chain.
+// Engines without intra-chain regions (has_intra = false, e.g. SSVS and horseshoe) cannot use the remaining threads,
+// so they run on min(nthreads, num_chains) threads when there are several chains.
+class ThreadBudget {
+public:
+	ThreadBudget(int nthreads, int num_chains, bool has_intra = true)
+	: num_chains(num_chains), chain_threads(std::max(1, std::min(nthreads, num_chains))),
+		spare_threads(has_intra || num_chains == 1 ? std::max(0, nthreads - chain_threads) : 0) {}
+	virtual ~ThreadBudget() = default;
+	int chainThreads() const {
+		return chain_threads;
+	}
+	int eigenThreads() const {
+		return num_chains == 1 ? chain_threads + spare_threads : 1;
+	}
+	// Threads within chain: the remainder goes to the first chains
+	int intraThreads(int chain) const {
+		if (num_chains > chain_threads) {
+			return 1; // chains alone keep every thread busy
+		}
+		return 1 + spare_threads / chain_threads + (chain < spare_threads % chain_threads ? 1 : 0);
+	}
+	// Chains advanced together by each thread when chains outnumber threads
+	int lockstepSize() const {
+		return num_chains > chain_threads ? (num_chains + chain_threads - 1) / chain_threads : 1;
+	}
+	// Chain-level region with nested intra-chain regions
+	bool isNested() const {
+		return num_chains > 1 && num_chains <= chain_threads && spare_threads > 0;
+	}
+private:
+	int num_chains;
+	int chain_threads;
+	int spare_threads;
+};
+
+} // namespace bvhar
 
 #endif // BVHAROMP_H
@@ -0,0 +1,124 @@
+#ifndef BVHARRECORD_H
+#define BVHARRECORD_H
+
+#include "bvharsummary.h"
+
+namespace bvhar {
+
+// Retained Draws of One Parameter
+//
+// Only the draws returned to R are stored: every thin-th draw after num_burn (num_burn = -1 keeps the initial value).
+// The storage is an R numeric matrix allocated with the sampler, and the chains write its rows through an Eigen map,
+// so returnRecord() hands the same memory to R instead of copying it.
+// With an active SummarySpec, the retained draws update a McmcSummary instead, and no draw is stored.
+// Build and return records on the main thread, since both touch R memory; assign() does not.
+class McmcRecord {
+public:
+	McmcRecord(int num_iter, int num_burn, int thin, int num_col, const SummarySpec& summary_spec, bool is_indicator = false, bool is_vector = false)
+	: num_burn(num_burn), thin(thin), is_summary(summary_spec.is_active),
+		num_keep(is_summary ? 0 : countKept(num_iter, num_burn, thin)), is_vector(is_vector),
+		r_record(Rcpp::no_init(num_keep * num_col)), record(r_record.begin(), num_keep, num_col),
+		summary(is_summary ? num_col : 0, summary_spec.prob, is_indicator) {
+		if (!is_vector) {
+			r_record.attr("dim") = Rcpp::Dimension(num_keep, num_col);
+		}
+	}
+	virtual ~McmcRecord() = default;
+	int cols() const {
+		return record.cols();
+	}
+	bool isSummary() const {
+		return is_summary;
+	}
+	// Number of retained draws through step
+	int numKept(int step) const {
+		return countKept(step, num_burn, thin);
+	}
+	const Eigen::Map<Eigen::MatrixXd>& getRecord() const {
+		return record;
+	}
+	// Writes the draw of step only when it is retained
+	template <typename Derived>
+	void assign(int step, const Eigen::MatrixBase<Derived>& draw) {
+		if (!isKept(step)) {
+			return;
+		}
+		if (is_summary) {
+			summary.update(draw);
+		} else {
+			record.row(rowOf(step)) = draw;
+		}
+	}
+	void assign(int step, double draw) {
+		assign(step, Eigen::Matrix<double, 1, 1>::Constant(draw));
+	}
+	// Retained draws through step: the R object itself unless sampling stopped early.
+	// In summary mode, list of mean, var, quantile, and num_draw (mean and num_draw for indicators).
+	SEXP returnRecord(int step) const {
+		if (is_summary) {
+			return summary.returnSummary();
+		}
+		int num_row = numKept(step);
+		if (num_row == num_keep) {
+			return r_record;
+		}
+		Rcpp::NumericVector res(Rcpp::no_init(num_row * record.cols()));
+		Eigen::Map<Eigen::MatrixXd>(res.begin(), num_row, record.cols()) = record.topRows(num_row);
+		if (!is_vector) {
+			res.attr("dim") = Rcpp::Dimension(num_row, record.cols());
+		}
+		return res;
+	}
+	// Retained draws through step in chosen columns. Empty col_id selects every column.
+	Eigen::MatrixXd returnTrace(int step, const Eigen::VectorXi& col_id) const {
+		int num_row = numKept(step);
+		if (col_id.size() == 0) {
+			return record.topRows(num_row);
+		}
+		Eigen::MatrixXd res(num_row, col_id.size());
+		for (int j = 0; j < col_id.size(); j++) {
+			res.col(j) = record.col(col_id[j]).head(num_row);
+		}
+		return res;
+	}
+	// Checkpoint: retained draws or summary so far
+	void saveRecord(std::ostream& os, int step) const {
+		if (is_summary) {
+			summary.saveState(os);
+			return;
+		}
+		Eigen::MatrixXd written = record.topRows(numKept(step));
+		write_state(os, written);
+	}
+	void loadRecord(std::istream& is, int step) {
+		if (is_summary) {
+			summary.loadState(is);
+			return;
+		}
+		Eigen::MatrixXd written(numKept(step), record.cols());
+		read_state(is, written);
+		record.topRows(written.rows()) = written;
+	}
+private:
+	int num_burn;
+	int thin;
+	bool is_summary;
+	int num_keep;
+	bool is_vector; // returned without dim attribute
+	Rcpp::NumericVector r_record;
+	Eigen::Map<Eigen::MatrixXd> record;
+	McmcSummary summary;
+	bool isKept(int step) const {
+		return step > num_burn && (step - num_burn - 1) % thin == 0;
+	}
+	int rowOf(int step) const {
+		return (step - num_burn - 1) / thin;
+	}
+	static int countKept(int step, int num_burn, int thin) {
+		return step > num_burn ? (step - num_burn + thin - 1) / thin : 0;
+	}
+};
+
+} // namespace bvhar
+
+#endif // BVHARRECORD_H
@@ -211,6 +211,104 @@ inline Eigen::VectorXd sim_gig(int num_sim, double lambda, double psi, double ch
 	return res;
 }
 
+// Innovations of Several Paths at One Time Point
+// 
+// @param num_path Number of paths
+// @param chol_upper Upper cholesky factor of the (scale) matrix
+// @param process 1: Gaussian, 2: Multivariate t
+// @param mvt_df Degrees of freedom of multivariate t
+// @param rng RNG stream of the block of paths
+inline Eigen::MatrixXd sim_innovation(int num_path, const Eigen::MatrixXd& chol_upper, int process, double mvt_df,
+																			boost::random::mt19937& rng) {
+	Eigen::MatrixXd res(num_path, chol_upper.cols());
+	for (int i = 0; i < num_path; i++) {
+		for (int j = 0; j < res.cols(); j++) {
+			res(i, j) = normal_rand(rng);
+		}
+	}
+	res = res * chol_upper.triangularView<Eigen::Upper>(); // use upper because now dealing with row vectors
+	if (process == 2) {
+		for (int i = 0; i < num_path; i++) {
+			res.row(i) *= sqrt(mvt_df / gamma_rand(mvt_df / 2, 2.0, rng)); // chi-square(df) = gamma(df / 2, scale = 2)
+		}
+	}
+	return res;
+}
+
+// Normal-IW Sampler Sharing Factorizations
+// 
+// Cholesky factors of the MN row scale and the IW scale are computed once for every draw.
+// Each draw only builds the Bartlett factor Q, solves Q A^T = L^T for the lower factor A of Sigma = A A^T,
+// and composes MN draw M + P Z A^T without another decomposition.
+class MniwSampler {
+public:
+	MniwSampler(const Eigen::MatrixXd& mat_mean, const Eigen::MatrixXd& mat_scale_u, const Eigen::MatrixXd& mat_scale, double shape)
+	: dim(mat_scale.cols()), shape(shape), mn_mean(mat_mean) {
+		if (shape <= dim - 1) {
+			Rcpp::stop("Wrong 'shape'. shape > dim - 1 must be satisfied.");
+		}
+		if (mat_scale.rows() != dim) {
+			Rcpp::stop("Invalid 'mat_scale' dimension.");
+		}
+		if (mat_scale_u.rows() != mat_scale_u.cols() || mat_scale_u.rows() != mat_mean.rows()) {
+			Rcpp::stop("Invalid 'mat_scale_u' dimension.");
+		}
+		if (mat_mean.cols() != dim) {
+			Rcpp::stop("Invalid 'mat_mean' dimension.");
+		}
+		chol_u = mat_scale_u.llt().matrixL();
+		chol_scale = mat_scale.llt().matrixL();
+	}
+	virtual ~MniwSampler() = default;
+	void draw(Eigen::MatrixXd& mn_draw, Eigen::MatrixXd& iw_draw) const {
+		Eigen::MatrixXd mat_bartlett = Eigen::MatrixXd::Zero(dim, dim);
+		for (int i = 0; i < dim; i++) {
+			mat_bartlett(i, i) = sqrt(chisq_rand(shape - (double)i)); // qii^2 ~ chi^2(nu - i + 1)
+		}
+		for (int i = 0; i < dim - 1; i++) {
+			for (int j = i + 1; j < dim; j++) {
+				mat_bartlett(i, j) = norm_rand();
+			}
+		}
+		Eigen::MatrixXd mat_norm(mn_mean.rows(), dim);
+		for (int i = 0; i < mat_norm.rows(); i++) {
+			for (int j = 0; j < dim; j++) {
+				mat_norm(i, j) = norm_rand();
+			}
+		}
+		compose(mat_bartlett, mat_norm, mn_draw, iw_draw);
+	}
+	void draw(Eigen::MatrixXd& mn_draw, Eigen::MatrixXd& iw_draw, boost::random::mt19937& rng) const {
+		Eigen::MatrixXd mat_bartlett = Eigen::MatrixXd::Zero(dim, dim);
+		for (int i = 0; i < dim; i++) {
+			mat_bartlett(i, i) = sqrt(gamma_rand((shape - (double)i) / 2, 2.0, rng)); // chi-square(df) = gamma(df / 2, scale = 2)
+		}
+		for (int i = 0; i < dim - 1; i++) {
+			for (int j = i + 1; j < dim; j++) {
+				mat_bartlett(i, j) = normal_rand(rng);
+			}
+		}
+		Eigen::MatrixXd mat_norm(mn_mean.rows(), dim);
+		for (int i = 0; i < mat_norm.rows(); i++) {
+			for (int j = 0; j < dim; j++) {
+				mat_norm(i, j) = normal_rand(rng);
+			}
+		}
+		compose(mat_bartlett, mat_norm, mn_draw, iw_draw);
+	}
+private:
+	int dim;
+	double shape;
+	Eigen::MatrixXd mn_mean;
+	Eigen::MatrixXd chol_u; // P: U = P P^T
+	Eigen::MatrixXd chol_scale; // L: Psi = L L^T
+	void compose(const Eigen::MatrixXd& mat_bartlett, const Eigen::MatrixXd& mat_norm, Eigen::MatrixXd& mn_draw, Eigen::MatrixXd& iw_draw) const {
+		Eigen::MatrixXd chol_iw_t = mat_bartlett.triangularView<Eigen::Upper>().solve(chol_scale.transpose()); // A^T = Q^(-1) L^T
+		iw_draw = chol_iw_t.transpose() * chol_iw_t;
+		mn_draw = mn_mean + chol_u.triangularView<Eigen::Lower>() * mat_norm * chol_iw_t.triangularView<Eigen::Upper>();
+	}
+};
+
 } //namespace bvhar
 
 #endif // BVHARSIM_H
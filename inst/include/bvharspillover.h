@@ -0,0 +1,117 @@
+#ifndef BVHARSPILLOVER_H
+#define BVHARSPILLOVER_H
+
+#include "ols.h"
+#include "minnesota.h"
+#include "bvharstructural.h"
+#include "bvharomp.h"
+#include <memory>
+
+namespace bvhar {
+
+// Generalized FEVD
+//
+// @param vma VMA [W0^T, W1^T, ..., W(h - 1)^T]^T
+// @param cov_mat Covariance matrix
+// @return Row-normalized generalized FEVD whose (i, j) is the share of variable i's forecast error variance due to shock j
+inline Eigen::MatrixXd compute_gfevd(const Eigen::MatrixXd& vma, const Eigen::MatrixXd& cov_mat) {
+	int dim = cov_mat.cols();
+	int step = vma.rows() / dim;
+	Eigen::MatrixXd numer = Eigen::MatrixXd::Zero(dim, dim);
+	Eigen::VectorXd denom = Eigen::VectorXd::Zero(dim);
+	for (int i = 0; i < step; i++) {
+		Eigen::MatrixXd ma_cov = vma.middleRows(i * dim, dim).transpose() * cov_mat; // Wi Sigma
+		numer += ma_cov.cwiseAbs2();
+		denom += (ma_cov * vma.middleRows(i * dim, dim)).diagonal(); // diag(Wi Sigma Wi^T)
+	}
+	Eigen::MatrixXd res = (numer.array().colwise() / denom.array()).rowwise() / cov_mat.diagonal().transpose().array();
+	return res.array().colwise() / res.rowwise().sum().array();
+}
+
+class Spillover {
+public:
+	Spillover(const Eigen::MatrixXd& coef_mat, int ord, const Eigen::MatrixXd& cov_mat, int step)
+	: dim(cov_mat.cols()), step(step),
+		coef(coef_mat), ord(ord), cov(cov_mat) {}
+	Spillover(const OlsFit& fit, int step) : Spillover(fit._coef, fit._ord, fit._cov, step) {}
+	Spillover(const MinnFit& fit, int step)
+	: Spillover(fit._coef, fit._ord, fit._iw_scale / (fit._iw_shape - fit._iw_scale.cols() - 1), step) {} // posterior mean of Sigma
+	virtual ~Spillover() = default;
+	void computeSpillover() {
+		spillover = 100 * compute_gfevd(build_vma(coef, ord, step - 1), cov);
+	}
+	Eigen::MatrixXd returnSpillover() {
+		return spillover;
+	}
+	Eigen::VectorXd returnTo() {
+		return spillover.colwise().sum().transpose() - spillover.diagonal(); // from j to others
+	}
+	Eigen::VectorXd returnFrom() {
+		return spillover.rowwise().sum() - spillover.diagonal(); // from others to i
+	}
+	double returnTot() {
+		return returnFrom().sum() / dim;
+	}
+private:
+	int dim;
+	int step;
+	Eigen::MatrixXd coef;
+	int ord;
+	Eigen::MatrixXd cov;
+	Eigen::MatrixXd spillover;
+};
+
+// Collect Spillover Results of Every Window
+inline Rcpp::List return_spillover(std::vector<std::unique_ptr<Spillover>>& spillover) {
+	int num_horizon = spillover.size();
+	int dim = spillover[0]->returnSpillover().cols();
+	Eigen::MatrixXd connect_record(num_horizon, dim * dim);
+	Eigen::MatrixXd to_record(num_horizon, dim);
+	Eigen::MatrixXd from_record(num_horizon, dim);
+	Eigen::VectorXd tot_record(num_horizon);
+	for (int i = 0; i < num_horizon; i++) {
+		connect_record.row(i) = spillover[i]->returnSpillover().reshaped().transpose();
+		to_record.row(i) = spillover[i]->returnTo().transpose();
+		from_record.row(i) = spillover[i]->returnFrom().transpose();
+		tot_record[i] = spillover[i]->returnTot();
+	}
+	return Rcpp::List::create(
+		Rcpp::Named("connect") = connect_record,
+		Rcpp::Named("to") = to_record,
+		Rcpp::Named("from") = from_record,
+		Rcpp::Named("tot") = tot_record,
+		Rcpp::Named("net") = to_record - from_record
+	);
+}
+
+// Spillover of Every Rolling Window
+//
+// @param y Time series data
+// @param window Window size
+// @param step Forecast horizon of FEVD
+// @param ord VAR lag or VHAR month order, which each window should exceed
+// @param fit Fitter of one window returning OlsFit or MinnFit. Called inside the OpenMP region, so it must not touch R objects.
+// @param nthreads Number of threads for openmp
+template <typename Fitter>
+inline Rcpp::List compute_dynamic_spillover(const Eigen::MatrixXd& y, int window, int step, int ord, Fitter fit, int nthreads) {
+	int num_horizon = y.rows() - window + 1;
+	if (num_horizon < 1) {
+		Rcpp::stop("'window' should be smaller than the number of observations.");
+	}
+	if (window <= ord) {
+		Rcpp::stop("'window' should be larger than the lag or 'month'.");
+	}
+	std::vector<std::unique_ptr<Spillover>> spillover(num_horizon);
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nthreads)
+#endif
+	for (int window_id = 0; window_id < num_horizon; window_id++) {
+		spillover[window_id].reset(new Spillover(fit(y.middleRows(window_id, window)), step));
+		spillover[window_id]->computeSpillover();
+	}
+	return return_spillover(spillover);
+}
+
+} // namespace bvhar
+
+#endif // BVHARSPILLOVER_H
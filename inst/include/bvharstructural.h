@@ -0,0 +1,183 @@
+#ifndef BVHARSTRUCTURAL_H
+#define BVHARSTRUCTURAL_H
+
+#include "bvhardraw.h"
+#include "bvharomp.h"
+#include <algorithm> // std::sort
+
+namespace bvhar {
+
+// VMA Coefficients of VAR(p)
+//
+// @param var_coef VAR coefficient matrix whose first mp rows are [B1^T, ..., Bp^T]^T
+// @param var_lag VAR lag
+// @param lag_max Maximum lag for VMA
+// @return VMA [W0^T, W1^T, ..., W(lag_max)^T]^T
+inline Eigen::MatrixXd build_vma(const Eigen::MatrixXd& var_coef, int var_lag, int lag_max) {
+	int dim = var_coef.cols();
+	Eigen::MatrixXd ma = Eigen::MatrixXd::Zero(dim * (lag_max + 1), dim);
+	ma.topRows(dim) = Eigen::MatrixXd::Identity(dim, dim); // W0 = Im
+	for (int i = 1; i < lag_max + 1; i++) {
+		for (int k = 0; k < std::min(i, var_lag); k++) {
+			ma.middleRows(i * dim, dim) += var_coef.middleRows(k * dim, dim) * ma.middleRows((i - k - 1) * dim, dim); // Wi^T = sum(Bk^T * W(i - k)^T)
+		}
+	}
+	return ma;
+}
+
+// Spectral Radius of Companion Matrix
+//
+// @param var_coef VAR coefficient matrix whose first mp rows are [B1^T, ..., Bp^T]^T
+// @param var_lag VAR lag
+// @param companion Workspace of mp x mp companion matrix whose subdiagonal identity blocks are already filled
+inline double compute_spectral_radius(const Eigen::MatrixXd& var_coef, int var_lag, Eigen::MatrixXd& companion) {
+	int dim = var_coef.cols();
+	companion.topRows(dim) = var_coef.topRows(dim * var_lag).transpose(); // only the first block row changes across draws
+	return Eigen::EigenSolver<Eigen::MatrixXd>(companion, false).eigenvalues().cwiseAbs().maxCoeff();
+}
+
+// Upper Bound of Spectral Radius of Companion Matrix
+//
+// Spectral radius of companion matrix is at most the largest root of z^p = sum(||Ai|| z^(p - i)),
+// which is smaller than one if and only if sum(||Ai||) < 1.
+//
+// @param var_coef VAR coefficient matrix whose first mp rows are [B1^T, ..., Bp^T]^T
+// @param var_lag VAR lag
+inline double compute_companion_norm(const Eigen::MatrixXd& var_coef, int var_lag) {
+	int dim = var_coef.cols();
+	double res = 0;
+	for (int i = 0; i < var_lag; i++) {
+		res += var_coef.middleRows(i * dim, dim).cwiseAbs().colwise().sum().maxCoeff(); // infinity norm of Ai = Bi^T
+	}
+	return res;
+}
+
+// Lower Cholesky Factor of Covariance Matrix in Each Posterior Draw
+//
+// @param cov_draw Row of covariance record
+// @param dim Dimension of time series
+// @param cov_type 1: LDLT with [a, h] (SV), 2: upper Cholesky factor of precision matrix (SSVS), 3: scalar variance (Horseshoe)
+inline Eigen::MatrixXd build_impact(const Eigen::VectorXd& cov_draw, int dim, int cov_type) {
+	switch (cov_type) {
+	case 1: {
+		int num_lowerchol = dim * (dim - 1) / 2;
+		Eigen::MatrixXd contem_inv = build_inv_lower(dim, cov_draw.head(num_lowerchol)).triangularView<Eigen::UnitLower>().solve(Eigen::MatrixXd::Identity(dim, dim));
+		return contem_inv * (cov_draw.segment(num_lowerchol, dim).array() / 2).exp().matrix().asDiagonal(); // L^(-1) D^(1/2)
+	}
+	case 2: {
+		Eigen::MatrixXd chol_factor = cov_draw.reshaped(dim, dim); // Psi with Sigma^(-1) = Psi Psi^T
+		return chol_factor.transpose().triangularView<Eigen::Lower>().solve(Eigen::MatrixXd::Identity(dim, dim)); // Psi^(-T)
+	}
+	}
+	return sqrt(cov_draw[0]) * Eigen::MatrixXd::Identity(dim, dim);
+}
+
+// Sample Quantile of Each Column
+//
+// Same as the default (type 7) of R quantile().
+inline Eigen::MatrixXd compute_quantile(Eigen::MatrixXd draws, const Eigen::VectorXd& probs, int nthreads) {
+	int num_draws = draws.rows();
+	Eigen::MatrixXd res(probs.size(), draws.cols());
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nthreads)
+#endif
+	for (int j = 0; j < draws.cols(); j++) {
+		std::sort(draws.col(j).data(), draws.col(j).data() + num_draws);
+		for (int i = 0; i < probs.size(); i++) {
+			double id = (num_draws - 1) * probs[i];
+			int lo = static_cast<int>(std::floor(id));
+			int hi = std::min(lo + 1, num_draws - 1);
+			res(i, j) = draws(lo, j) + (id - lo) * (draws(hi, j) - draws(lo, j));
+		}
+	}
+	return res;
+}
+
+class McmcIrf {
+public:
+	McmcIrf(const Eigen::MatrixXd& coef_record, const Eigen::MatrixXd& cov_record, int cov_type, int var_lag, int lag_max)
+	: num_draws(coef_record.rows()), var_lag(var_lag), lag_max(lag_max),
+		dim(static_cast<int>(std::round(std::sqrt(static_cast<double>(coef_record.cols()) / var_lag)))),
+		coef_mat(num_draws), ma_state(num_draws, Eigen::MatrixXd::Zero(dim * var_lag, dim)),
+		impact(num_draws), fevd_num(num_draws, Eigen::MatrixXd::Zero(dim, dim)) {
+		for (int i = 0; i < num_draws; i++) {
+			coef_mat[i] = coef_record.row(i).reshaped(dim * var_lag, dim);
+			impact[i] = build_impact(cov_record.row(i), dim, cov_type);
+		}
+	}
+	virtual ~McmcIrf() = default;
+	void computeQuantile(const Eigen::VectorXd& probs, bool orthogonal, int nthreads) {
+		int num_prob = probs.size();
+		irf_quantile.assign(num_prob, Eigen::MatrixXd::Zero(dim * (lag_max + 1), dim));
+		fevd_quantile.assign(num_prob, Eigen::MatrixXd::Zero(dim * (lag_max + 1), dim));
+		irf_mean = Eigen::MatrixXd::Zero(dim * (lag_max + 1), dim);
+		fevd_mean = Eigen::MatrixXd::Zero(dim * (lag_max + 1), dim);
+		Eigen::MatrixXd irf_draws(num_draws, dim * dim); // one horizon at a time
+		Eigen::MatrixXd fevd_draws(num_draws, dim * dim);
+		for (int h = 0; h < lag_max + 1; h++) {
+		#ifdef _OPENMP
+			#pragma omp parallel for num_threads(nthreads)
+		#endif
+			for (int i = 0; i < num_draws; i++) {
+				Eigen::MatrixXd ma = updateVma(i, h); // Wh^T
+				Eigen::MatrixXd ortho_ma = impact[i].transpose() * ma; // (Wh P)^T
+				fevd_num[i] += ortho_ma.cwiseAbs2();
+				Eigen::MatrixXd fevd = fevd_num[i].array().rowwise() / fevd_num[i].colwise().sum().array(); // impulse x response
+				irf_draws.row(i) = orthogonal ? ortho_ma.reshaped().transpose() : ma.reshaped().transpose();
+				fevd_draws.row(i) = fevd.reshaped().transpose();
+			}
+			irf_mean.middleRows(h * dim, dim) = irf_draws.colwise().mean().reshaped(dim, dim);
+			fevd_mean.middleRows(h * dim, dim) = fevd_draws.colwise().mean().reshaped(dim, dim);
+			Eigen::MatrixXd irf_prob = compute_quantile(irf_draws, probs, nthreads);
+			Eigen::MatrixXd fevd_prob = compute_quantile(fevd_draws, probs, nthreads);
+			for (int j = 0; j < num_prob; j++) {
+				irf_quantile[j].middleRows(h * dim, dim) = irf_prob.row(j).reshaped(dim, dim);
+				fevd_quantile[j].middleRows(h * dim, dim) = fevd_prob.row(j).reshaped(dim, dim);
+			}
+		}
+	}
+	Rcpp::List returnIrf() {
+		Rcpp::List irf_res(irf_quantile.size());
+		Rcpp::List fevd_res(fevd_quantile.size());
+		for (int j = 0; j < static_cast<int>(irf_quantile.size()); j++) {
+			irf_res[j] = irf_quantile[j];
+			fevd_res[j] = fevd_quantile[j];
+		}
+		return Rcpp::List::create(
+			Rcpp::Named("irf_mean") = irf_mean,
+			Rcpp::Named("irf_quantile") = irf_res,
+			Rcpp::Named("fevd_mean") = fevd_mean,
+			Rcpp::Named("fevd_quantile") = fevd_res
+		);
+	}
+private:
+	int num_draws;
+	int var_lag;
+	int lag_max;
+	int dim;
+	std::vector<Eigen::MatrixXd> coef_mat; // VAR coefficient of each draw
+	std::vector<Eigen::MatrixXd> ma_state; // last p VMA blocks of each draw
+	std::vector<Eigen::MatrixXd> impact; // lower cholesky factor of each draw
+	std::vector<Eigen::MatrixXd> fevd_num; // cumulative squared orthogonal responses
+	std::vector<Eigen::MatrixXd> irf_quantile;
+	std::vector<Eigen::MatrixXd> fevd_quantile;
+	Eigen::MatrixXd irf_mean;
+	Eigen::MatrixXd fevd_mean;
+	Eigen::MatrixXd updateVma(int id, int horizon) {
+		// ma_state keeps W(h - 1)^T, ..., W(h - p)^T in circular slots h mod p
+		Eigen::MatrixXd ma = Eigen::MatrixXd::Zero(dim, dim);
+		if (horizon == 0) {
+			ma.setIdentity(); // W0 = Im
+		} else {
+			for (int k = 0; k < std::min(horizon, var_lag); k++) {
+				ma += coef_mat[id].middleRows(k * dim, dim) * ma_state[id].middleRows(((horizon - k - 1) % var_lag) * dim, dim); // Wh^T = sum(Bk^T * W(h - k)^T)
+			}
+		}
+		ma_state[id].middleRows((horizon % var_lag) * dim, dim) = ma;
+		return ma;
+	}
+};
+
+} // namespace bvhar
+
+#endif // BVHARSTRUCTURAL_H
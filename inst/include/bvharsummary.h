@@ -0,0 +1,213 @@
+#ifndef BVHARSUMMARY_H
+#define BVHARSUMMARY_H
+
+#include "bvharcheckpoint.h"
+#include <vector>
+#include <algorithm> // std::sort
+#include <cmath>
+
+namespace bvhar {
+
+// Streaming Summary Specification
+//
+// Empty spec list keeps every retained draw.
+struct SummarySpec {
+	bool is_active;
+	Eigen::VectorXd prob;
+	SummarySpec() : is_active(false) {}
+	SummarySpec(Rcpp::List& spec) : is_active(spec.size() > 0) {
+		if (is_active) {
+			prob = Rcpp::as<Eigen::VectorXd>(spec["prob"]);
+		}
+	}
+};
+
+// P-square Quantile Estimator of Each Column
+//
+// Five markers per column track the minimum, the p/2, p, (1 + p)/2 quantiles, and the maximum,
+// and are moved by piecewise-parabolic interpolation, so no draw is stored (Jain and Chlamtac, 1985).
+// Marker positions differ by column, but desired positions only depend on the number of draws.
+class P2Quantile {
+public:
+	P2Quantile(int num_col, double prob)
+	: prob(prob), height(5, num_col), pos(5, num_col), desired(5), increment(5) {
+		desired << 0, 2 * prob, 4 * prob, 2 + 2 * prob, 4;
+		increment << 0, prob / 2, prob, (1 + prob) / 2, 1;
+		for (int i = 0; i < 5; i++) {
+			pos.row(i).setConstant(i);
+		}
+	}
+	// num_draw: number of draws including x
+	void update(const Eigen::VectorXd& x, int num_draw) {
+		if (num_draw <= 5) {
+			height.row(num_draw - 1) = x;
+			if (num_draw == 5) {
+				for (int j = 0; j < height.cols(); j++) {
+					std::sort(height.col(j).data(), height.col(j).data() + 5);
+				}
+			}
+			return;
+		}
+		desired += increment;
+		for (int j = 0; j < height.cols(); j++) {
+			updateCol(j, x[j]);
+		}
+	}
+	Eigen::VectorXd returnQuantile(int num_draw) const {
+		if (num_draw >= 5) {
+			return height.row(2);
+		}
+		Eigen::VectorXd res = Eigen::VectorXd::Zero(height.cols());
+		if (num_draw == 0) {
+			return res;
+		}
+		// exact quantile of the first few draws as quantile(type = 7)
+		double id = prob * (num_draw - 1);
+		int low = static_cast<int>(std::floor(id));
+		int high = std::min(low + 1, num_draw - 1);
+		Eigen::VectorXd col_draw(num_draw);
+		for (int j = 0; j < height.cols(); j++) {
+			col_draw = height.col(j).head(num_draw);
+			std::sort(col_draw.data(), col_draw.data() + num_draw);
+			res[j] = col_draw[low] + (id - low) * (col_draw[high] - col_draw[low]);
+		}
+		return res;
+	}
+	void saveState(std::ostream& os) const {
+		write_state(os, height);
+		write_state(os, pos);
+		write_state(os, desired);
+	}
+	void loadState(std::istream& is) {
+		read_state(is, height);
+		read_state(is, pos);
+		read_state(is, desired);
+	}
+private:
+	double prob;
+	Eigen::MatrixXd height; // marker heights q_0, ..., q_4 of each column
+	Eigen::MatrixXd pos; // marker positions n_0, ..., n_4 of each column
+	Eigen::VectorXd desired; // desired positions
+	Eigen::VectorXd increment; // increments of desired positions
+	void updateCol(int j, double x) {
+		auto q = height.col(j);
+		auto n = pos.col(j);
+		int cell;
+		if (x < q[0]) {
+			q[0] = x;
+			cell = 0;
+		} else if (x >= q[4]) {
+			q[4] = x;
+			cell = 3;
+		} else {
+			cell = 0;
+			while (x >= q[cell + 1]) {
+				cell++;
+			}
+		}
+		n.tail(4 - cell).array() += 1;
+		for (int i = 1; i < 4; i++) {
+			double gap = desired[i] - n[i];
+			if ((gap >= 1 && n[i + 1] - n[i] > 1) || (gap <= -1 && n[i - 1] - n[i] < -1)) {
+				int d = gap > 0 ? 1 : -1;
+				double parabolic = q[i] + d / (n[i + 1] - n[i - 1]) * (
+					(n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+					(n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1])
+				);
+				if (q[i - 1] < parabolic && parabolic < q[i + 1]) {
+					q[i] = parabolic;
+				} else {
+					q[i] += d * (q[i + d] - q[i]) / (n[i + d] - n[i]);
+				}
+				n[i] += d;
+			}
+		}
+	}
+};
+
+// Streaming Posterior Summary of One Parameter
+//
+// Welford mean and variance, and P-square quantiles of each column, updated with every retained draw.
+// Indicators only count the draws equal to one, whose mean is the posterior inclusion probability.
+// Memory is O(number of columns) instead of O(iterations x columns).
+class McmcSummary {
+public:
+	McmcSummary(int num_col, const Eigen::VectorXd& prob, bool is_indicator)
+	: num_draw(0), is_indicator(is_indicator), mean(Eigen::VectorXd::Zero(num_col)), draw(num_col) {
+		if (!is_indicator) {
+			sq_dev = Eigen::VectorXd::Zero(num_col);
+			delta = Eigen::VectorXd::Zero(num_col);
+			for (int i = 0; i < prob.size(); i++) {
+				quantile.emplace_back(num_col, prob[i]);
+			}
+		}
+	}
+	template <typename Derived>
+	void update(const Eigen::MatrixBase<Derived>& new_draw) {
+		draw = new_draw.reshaped();
+		num_draw++;
+		if (is_indicator) {
+			mean.array() += (draw.array() == 1).cast<double>(); // count until returned
+			return;
+		}
+		delta = draw - mean;
+		mean += delta / num_draw;
+		sq_dev.array() += delta.array() * (draw - mean).array();
+		for (auto& sketch : quantile) {
+			sketch.update(draw, num_draw);
+		}
+	}
+	int numDraw() const {
+		return num_draw;
+	}
+	Rcpp::List returnSummary() const {
+		if (is_indicator) {
+			return Rcpp::List::create(
+				Rcpp::Named("mean") = num_draw > 0 ? (mean / num_draw).eval() : mean,
+				Rcpp::Named("num_draw") = num_draw
+			);
+		}
+		Eigen::MatrixXd quantile_mat(quantile.size(), mean.size());
+		for (int i = 0; i < static_cast<int>(quantile.size()); i++) {
+			quantile_mat.row(i) = quantile[i].returnQuantile(num_draw);
+		}
+		return Rcpp::List::create(
+			Rcpp::Named("mean") = mean,
+			Rcpp::Named("var") = num_draw > 1 ? (sq_dev / (num_draw - 1)).eval() : Eigen::VectorXd::Zero(mean.size()).eval(),
+			Rcpp::Named("quantile") = quantile_mat,
+			Rcpp::Named("num_draw") = num_draw
+		);
+	}
+	void saveState(std::ostream& os) const {
+		write_state(os, num_draw);
+		write_state(os, mean);
+		if (!is_indicator) {
+			write_state(os, sq_dev);
+			for (const auto& sketch : quantile) {
+				sketch.saveState(os);
+			}
+		}
+	}
+	void loadState(std::istream& is) {
+		read_state(is, num_draw);
+		read_state(is, mean);
+		if (!is_indicator) {
+			read_state(is, sq_dev);
+			for (auto& sketch : quantile) {
+				sketch.loadState(is);
+			}
+		}
+	}
+private:
+	int num_draw;
+	bool is_indicator;
+	Eigen::VectorXd mean; // running mean, or the number of ones in indicators
+	Eigen::VectorXd sq_dev; // running sum of squared deviations
+	std::vector<P2Quantile> quantile;
+	Eigen::VectorXd draw;
+	Eigen::VectorXd delta;
+};
+
+} // namespace bvhar
+
+#endif // BVHARSUMMARY_H
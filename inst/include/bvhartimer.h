@@ -0,0 +1,55 @@
+#ifndef BVHARTIMER_H
+#define BVHARTIMER_H
+
+#include <RcppEigen.h>
+#include <chrono>
+
+namespace bvhar {
+
+// Elapsed Time of Each Gibbs Step
+//
+// lap(stage) adds the time since the previous start() or lap() to the stage.
+// When inactive, start() and lap() only test a flag, so the clock is never read.
+class StageTimer {
+public:
+	StageTimer(int num_stage) : is_active(false), elapsed(Eigen::VectorXd::Zero(num_stage)) {}
+	virtual ~StageTimer() = default;
+	void setActive(bool active) {
+		is_active = active;
+	}
+	bool isActive() const {
+		return is_active;
+	}
+	void start() {
+		if (is_active) {
+			last = std::chrono::steady_clock::now();
+		}
+	}
+	void lap(int stage) {
+		if (is_active) {
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			elapsed[stage] += std::chrono::duration<double>(now - last).count();
+			last = now;
+		}
+	}
+	// lap() for work shared by num_share timers, which adds only its share to the stage
+	void share(int stage, int num_share) {
+		if (is_active) {
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			elapsed[stage] += std::chrono::duration<double>(now - last).count() / num_share;
+			last = now;
+		}
+	}
+	// Seconds spent in each stage
+	const Eigen::VectorXd& returnTime() const {
+		return elapsed;
+	}
+private:
+	bool is_active;
+	Eigen::VectorXd elapsed;
+	std::chrono::steady_clock::time_point last;
+};
+
+} // namespace bvhar
+
+#endif // BVHARTIMER_H
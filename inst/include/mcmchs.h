@@ -3,13 +3,22 @@
 
 #include "bvhardraw.h"
 #include "bvharprogress.h"
+#include "bvharrecord.h"
+#include <memory>
 
 namespace bvhar {
 
+// I_k otimes X0 and vec(Y0) are built once here and shared by every chain.
 struct HsParams {
 	int _iter;
-	Eigen::MatrixXd _x;
-	Eigen::MatrixXd _y;
+	int _burn;
+	int _thin;
+	SummarySpec _summary;
+	std::shared_ptr<const Eigen::MatrixXd> _design_mat;
+	std::shared_ptr<const Eigen::VectorXd> _response_vec;
+	int _dim;
+	int _dim_design;
+	int _num_design;
 	Eigen::VectorXd _init_local;
 	Eigen::VectorXd _init_global;
 	double _init_sigma;
@@ -17,11 +26,14 @@ struct HsParams {
 	Eigen::MatrixXi _grp_mat;
 	
 	HsParams(
-		int num_iter, const Eigen::MatrixXd& x, const Eigen::MatrixXd& y,
+		int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, const Eigen::Ref<const Eigen::MatrixXd>& x, const Eigen::Ref<const Eigen::MatrixXd>& y,
     const Eigen::VectorXd& init_local, const Eigen::VectorXd& init_global, const double& init_sigma,
 		const Eigen::VectorXi& grp_id, const Eigen::MatrixXi& grp_mat
 	)
-	: _iter(num_iter), _x(x), _y(y),
+	: _iter(num_iter), _burn(num_burn), _thin(thin), _summary(summary_spec),
+		_design_mat(std::make_shared<const Eigen::MatrixXd>(kronecker_eigen(Eigen::MatrixXd::Identity(y.cols(), y.cols()), x))),
+		_response_vec(std::make_shared<const Eigen::VectorXd>(y.reshaped())),
+		_dim(y.cols()), _dim_design(x.cols()), _num_design(y.rows()),
 		_init_local(init_local), _init_global(init_global), _init_sigma(init_sigma),
 		_grp_id(grp_id), _grp_mat(grp_mat) {}
 };
@@ -30,11 +42,11 @@ class McmcHs {
 public:
 	McmcHs(const HsParams& params, unsigned int seed)
 	: num_iter(params._iter),
-		dim(params._y.cols()), dim_design(params._x.cols()), num_design(params._y.rows()),
+		dim(params._dim), dim_design(params._dim_design), num_design(params._num_design),
 		num_coef(dim * dim_design),
 		mcmc_step(0), rng(seed),
-		design_mat(kronecker_eigen(Eigen::MatrixXd::Identity(dim, dim), params._x)),
-		response_vec(vectorize_eigen(params._y)),
+		shared_design(params._design_mat), shared_response(params._response_vec),
+		design_mat(*shared_design), response_vec(*shared_response),
 		lambda_mat(Eigen::MatrixXd::Zero(num_coef, num_coef)),
 		grp_id(params._grp_id), grp_mat(params._grp_mat), grp_vec(vectorize_eigen(grp_mat)), num_grp(grp_id.size()),
 		coef_draw(Eigen::VectorXd::Zero(num_coef)), sig_draw(params._init_sigma),
@@ -44,11 +56,11 @@ public:
 		latent_global(Eigen::VectorXd::Zero(num_grp)),
 		coef_var(Eigen::VectorXd::Zero(num_coef)),
 		coef_var_loc(Eigen::MatrixXd::Zero(dim_design, dim)),
-		coef_record(Eigen::MatrixXd::Zero(num_iter + 1, num_coef)),
-		local_record(Eigen::MatrixXd::Zero(num_iter + 1, num_coef)),
-		global_record(Eigen::MatrixXd::Zero(num_iter + 1, num_grp)),
-		sig_record(Eigen::VectorXd::Zero(num_iter + 1)),
-		shrink_record(Eigen::MatrixXd::Zero(num_iter + 1, num_coef)) {}
+		coef_record(num_iter, params._burn, params._thin, num_coef, params._summary),
+		local_record(num_iter, params._burn, params._thin, num_coef, params._summary),
+		global_record(num_iter, params._burn, params._thin, num_grp, params._summary),
+		sig_record(num_iter, params._burn, params._thin, 1, params._summary, false, true),
+		shrink_record(num_iter, params._burn, params._thin, num_coef, params._summary) {}
 	virtual ~McmcHs() = default;
 	void addStep() { mcmc_step++; }
 	void updateCoefCov() {
@@ -73,11 +85,11 @@ public:
 		horseshoe_mn_global_sparsity(global_lev, grp_vec, grp_id, latent_global, local_lev, coef_draw, sig_draw, rng);
 	}
 	virtual void updateRecords() {
-		shrink_record.row(mcmc_step) = shrink_fac;
-		coef_record.row(mcmc_step) = coef_draw;
-		sig_record[mcmc_step] = sig_draw;
-		local_record.row(mcmc_step) = local_lev;
-		global_record.row(mcmc_step) = global_lev;
+		shrink_record.assign(mcmc_step, shrink_fac);
+		coef_record.assign(mcmc_step, coef_draw);
+		sig_record.assign(mcmc_step, sig_draw);
+		local_record.assign(mcmc_step, local_lev);
+		global_record.assign(mcmc_step, global_lev);
 	}
 	void doPosteriorDraws() {
 		std::lock_guard<std::mutex> lock(mtx);
@@ -87,22 +99,49 @@ public:
 		updateCov();
 		updateRecords();
 	}
-	Rcpp::List returnRecords(int num_burn, int thin) const {
-		Rcpp::List res = Rcpp::List::create(
-			Rcpp::Named("alpha_record") = coef_record,
-			Rcpp::Named("lambda_record") = local_record,
-			Rcpp::Named("tau_record") = global_record,
-			Rcpp::Named("sigma_record") = sig_record,
-			Rcpp::Named("kappa_record") = shrink_record
+	Rcpp::List returnRecords() const {
+		return Rcpp::List::create(
+			Rcpp::Named("alpha_record") = coef_record.returnRecord(mcmc_step),
+			Rcpp::Named("lambda_record") = local_record.returnRecord(mcmc_step),
+			Rcpp::Named("tau_record") = global_record.returnRecord(mcmc_step),
+			Rcpp::Named("sigma_record") = sig_record.returnRecord(mcmc_step),
+			Rcpp::Named("kappa_record") = shrink_record.returnRecord(mcmc_step)
 		);
-		for (auto& record : res) {
-			if (Rcpp::is<Rcpp::NumericMatrix>(record)) {
-				record = thin_record(Rcpp::as<Eigen::MatrixXd>(record), num_iter, num_burn, thin);
-			} else {
-				record = thin_record(Rcpp::as<Eigen::VectorXd>(record), num_iter, num_burn, thin);
-			}
-		}
-		return res;
+	}
+	Eigen::MatrixXd returnCoefTrace(const Eigen::VectorXi& param_id) const {
+		return coef_record.returnTrace(mcmc_step, param_id);
+	}
+	// Checkpoint: parameters carried over to the next iteration, RNG, and records written so far
+	virtual void saveState(std::ostream& os) const {
+		int step = mcmc_step;
+		write_state(os, step);
+		write_state(os, rng);
+		write_state(os, coef_draw);
+		write_state(os, sig_draw);
+		write_state(os, local_lev);
+		write_state(os, global_lev);
+		write_state(os, coef_var_loc);
+		coef_record.saveRecord(os, step);
+		local_record.saveRecord(os, step);
+		global_record.saveRecord(os, step);
+		sig_record.saveRecord(os, step);
+		shrink_record.saveRecord(os, step);
+	}
+	virtual void loadState(std::istream& is) {
+		int step;
+		read_state(is, step);
+		mcmc_step = step;
+		read_state(is, rng);
+		read_state(is, coef_draw);
+		read_state(is, sig_draw);
+		read_state(is, local_lev);
+		read_state(is, global_lev);
+		read_state(is, coef_var_loc);
+		coef_record.loadRecord(is, step);
+		local_record.loadRecord(is, step);
+		global_record.loadRecord(is, step);
+		sig_record.loadRecord(is, step);
+		shrink_record.loadRecord(is, step);
 	}
 protected:
 	int num_iter;
@@ -113,8 +152,10 @@ protected:
 	std::mutex mtx;
 	std::atomic<int> mcmc_step; // MCMC step
 	boost::random::mt19937 rng; // RNG instance for multi-chain
-	Eigen::MatrixXd design_mat;
-	Eigen::VectorXd response_vec;
+	std::shared_ptr<const Eigen::MatrixXd> shared_design;
+	std::shared_ptr<const Eigen::VectorXd> shared_response;
+	const Eigen::MatrixXd& design_mat; // I_k otimes X0 shared by chains
+	const Eigen::VectorXd& response_vec; // vec(Y0) shared by chains
 	Eigen::MatrixXd lambda_mat; // covariance
 	Eigen::VectorXi grp_id;
 	Eigen::MatrixXi grp_mat;
@@ -130,11 +171,11 @@ protected:
 	Eigen::VectorXd latent_global;
 	Eigen::VectorXd coef_var;
 	Eigen::MatrixXd coef_var_loc;
-	Eigen::MatrixXd coef_record;
-  Eigen::MatrixXd local_record;
-  Eigen::MatrixXd global_record; // tau1: own-lag, tau2: cross-lag, ...
-  Eigen::VectorXd sig_record;
-  Eigen::MatrixXd shrink_record;
+	McmcRecord coef_record;
+  McmcRecord local_record;
+  McmcRecord global_record; // tau1: own-lag, tau2: cross-lag, ...
+  McmcRecord sig_record;
+  McmcRecord shrink_record;
 };
 
 class BlockHs : public McmcHs {
@@ -143,11 +184,19 @@ public:
 	virtual ~BlockHs() = default;
 	void updateCoef() override { horseshoe_coef_var(block_coef, response_vec, design_mat, lambda_mat, rng); }
 	void updateRecords() override {
-		shrink_record.row(mcmc_step) = shrink_fac;
-		coef_record.row(mcmc_step) = block_coef.tail(num_coef);
-		sig_record[mcmc_step] = block_coef[0];
-		local_record.row(mcmc_step) = local_lev;
-		global_record.row(mcmc_step) = global_lev;
+		shrink_record.assign(mcmc_step, shrink_fac);
+		coef_record.assign(mcmc_step, block_coef.tail(num_coef));
+		sig_record.assign(mcmc_step, block_coef[0]);
+		local_record.assign(mcmc_step, local_lev);
+		global_record.assign(mcmc_step, global_lev);
+	}
+	void saveState(std::ostream& os) const override {
+		McmcHs::saveState(os);
+		write_state(os, block_coef);
+	}
+	void loadState(std::istream& is) override {
+		McmcHs::loadState(is);
+		read_state(is, block_coef);
 	}
 private:
 	Eigen::VectorXd block_coef;
@@ -168,11 +217,11 @@ public:
 		sig_draw = horseshoe_var(response_vec, design_mat, lambda_mat, rng);
 	}
 	void updateRecords() override {
-		shrink_record.row(mcmc_step) = shrink_fac;
-		coef_record.row(mcmc_step) = coef_draw;
-		sig_record[mcmc_step] = sig_draw;
-		local_record.row(mcmc_step) = local_lev;
-		global_record.row(mcmc_step) = global_lev;
+		shrink_record.assign(mcmc_step, shrink_fac);
+		coef_record.assign(mcmc_step, coef_draw);
+		sig_record.assign(mcmc_step, sig_draw);
+		local_record.assign(mcmc_step, local_lev);
+		global_record.assign(mcmc_step, global_lev);
 	}
 };
 
@@ -3,13 +3,14 @@
 
 #include "bvhardraw.h"
 #include "bvharprogress.h"
+#include "bvharrecord.h"
 
 namespace bvhar {
 
 class McmcSsvs {
 public:
 	McmcSsvs(
-		int num_iter, const Eigen::MatrixXd& x, const Eigen::MatrixXd& y,
+		int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, const Eigen::Ref<const Eigen::MatrixXd>& x, const Eigen::Ref<const Eigen::MatrixXd>& y,
 		const Eigen::VectorXd& init_coef, const Eigen::VectorXd& init_chol_diag, const Eigen::VectorXd& init_chol_upper,
   	const Eigen::VectorXd& init_coef_dummy, const Eigen::VectorXd& init_chol_dummy,
   	const Eigen::VectorXd& coef_spike, const Eigen::VectorXd& coef_slab, const Eigen::VectorXd& coef_slab_weight,
@@ -21,7 +22,7 @@ public:
   	const Eigen::VectorXd& mean_non, const double& sd_non, bool include_mean, bool init_gibbs,
 		unsigned int seed
 	)
-	: num_iter(num_iter), x(x), y(y),
+	: num_iter(num_iter),
 		dim(y.cols()), dim_design(x.cols()), num_design(y.rows()),
 		num_coef(dim * dim_design), num_upperchol(dim * (dim - 1) / 2),
 		mcmc_step(0), rng(seed),
@@ -38,9 +39,17 @@ public:
 		coef_mean(Eigen::VectorXd::Zero(num_restrict)), prior_mean(Eigen::VectorXd::Zero(num_coef)),
 		coef_mixture_mat(Eigen::VectorXd(num_restrict)), chol_mixture_mat(Eigen::VectorXd(num_restrict)),
 		slab_weight(Eigen::VectorXd(num_restrict)), slab_weight_mat(Eigen::MatrixXd(num_restrict / dim, dim)),
-		gram(x.transpose() * x),
-		coef_ols(gram.llt().solve(x.transpose() * y)), coef_vec(vectorize_eigen(coef_ols)),
-		chol_ols(((y - x * coef_ols).transpose() * (y - x * coef_ols) / (num_design - dim_design)).llt().matrixU()) {
+		gram(x.transpose() * x), xty(x.transpose() * y), yty(y.transpose() * y),
+		coef_ols(gram.llt().solve(xty)), coef_vec(vectorize_eigen(coef_ols)),
+		chol_ols((computeSse(coef_ols) / (num_design - dim_design)).llt().matrixU()),
+		coef_record(num_iter, num_burn, thin, num_coef, summary_spec),
+		coef_dummy_record(num_iter, num_burn, thin, num_restrict, summary_spec, true),
+		coef_weight_record(num_iter, num_burn, thin, num_grp, summary_spec),
+		chol_diag_record(num_iter, num_burn, thin, dim, summary_spec),
+		chol_upper_record(num_iter, num_burn, thin, num_upperchol, summary_spec),
+		chol_dummy_record(num_iter, num_burn, thin, num_upperchol, summary_spec, true),
+		chol_weight_record(num_iter, num_burn, thin, num_upperchol, summary_spec),
+		chol_factor_record(num_iter, num_burn, thin, dim * dim, summary_spec) {
 		if (include_mean) {
 			for (int j = 0; j < dim; j++) {
 				prior_mean.segment(j * dim_design, num_restrict / dim) = coef_mean.segment(j * num_restrict / dim, num_restrict / dim);
@@ -49,14 +58,6 @@ public:
 		} else {
 			prior_mean = coef_mean;
 		}
-		coef_record = Eigen::MatrixXd::Zero(num_iter + 1, num_coef);
-		coef_dummy_record = Eigen::MatrixXd::Zero(num_iter + 1, num_restrict);
-		coef_weight_record = Eigen::MatrixXd::Zero(num_iter + 1, num_grp);
-		chol_diag_record = Eigen::MatrixXd::Zero(num_iter + 1, dim);
-		chol_upper_record = Eigen::MatrixXd::Zero(num_iter + 1, num_upperchol);
-		chol_dummy_record = Eigen::MatrixXd::Zero(num_iter + 1, num_upperchol);
-		chol_weight_record = Eigen::MatrixXd::Zero(num_iter + 1, num_upperchol);
-		chol_factor_record = Eigen::MatrixXd::Zero(num_iter + 1, dim * dim);
 		coef_weight = coef_slab_weight;
 		chol_weight = chol_slab_weight;
 		if (init_gibbs) {
@@ -78,20 +79,19 @@ public:
 			chol_factor = chol_ols;
 		}
 		coef_mat = unvectorize(coef_draw, dim);
-		sse_mat = (y - x * coef_mat).transpose() * (y - x * coef_mat);
-		coef_record.row(0) = coef_draw;
-		coef_dummy_record.row(0) = coef_dummy;
-		chol_diag_record.row(0) = chol_diag;
-		chol_upper_record.row(0) = chol_coef;
-		chol_dummy_record.row(0) = chol_dummy;
-		chol_factor_record.row(0) = vectorize_eigen(chol_factor);
+		sse_mat = computeSse(coef_mat);
+		coef_record.assign(0, coef_draw);
+		coef_dummy_record.assign(0, coef_dummy);
+		chol_diag_record.assign(0, chol_diag);
+		chol_upper_record.assign(0, chol_coef);
+		chol_dummy_record.assign(0, chol_dummy);
+		chol_factor_record.assign(0, vectorize_eigen(chol_factor));
 	}
 	virtual ~McmcSsvs() = default;
 	void addStep() { mcmc_step++; }
 	void updateChol() {
 		chol_mixture_mat = build_ssvs_sd(chol_spike, chol_slab, chol_dummy);
-		ssvs_chol_diag(chol_diag, sse_mat, chol_mixture_mat, shape, rate, num_design, rng);
-		ssvs_chol_off(chol_coef, sse_mat, chol_diag, chol_mixture_mat, rng);
+		ssvs_chol(chol_diag, chol_coef, sse_mat, chol_mixture_mat, shape, rate, num_design, rng);
 		chol_factor = build_chol(chol_diag, chol_coef);
 	}
 	void updateCholDummy() {
@@ -110,7 +110,7 @@ public:
 		}
 		ssvs_coef(coef_draw, prior_mean, prior_sd, gram, coef_vec, chol_factor, rng);
 		coef_mat = unvectorize(coef_draw, dim);
-		sse_mat = (y - x * coef_mat).transpose() * (y - x * coef_mat);
+		sse_mat = computeSse(coef_mat);
 	}
 	void updateCoefDummy() {
 		for (int j = 0; j < num_grp; j++) {
@@ -131,14 +131,14 @@ public:
 		ssvs_mn_weight(coef_weight, grp_vec, grp_id, coef_dummy, coef_s1, coef_s2, rng);
 	}
 	void updateRecords() {
-		chol_upper_record.row(mcmc_step) = chol_coef;
-		chol_diag_record.row(mcmc_step) = chol_diag;
-		chol_factor_record.row(mcmc_step) = vectorize_eigen(chol_factor);
-		chol_dummy_record.row(mcmc_step) = chol_dummy;
-		chol_weight_record.row(mcmc_step) = chol_weight;
-		coef_record.row(mcmc_step) = coef_draw;
-		coef_dummy_record.row(mcmc_step) = coef_dummy;
-		coef_weight_record.row(mcmc_step) = coef_weight;
+		chol_upper_record.assign(mcmc_step, chol_coef);
+		chol_diag_record.assign(mcmc_step, chol_diag);
+		chol_factor_record.assign(mcmc_step, vectorize_eigen(chol_factor));
+		chol_dummy_record.assign(mcmc_step, chol_dummy);
+		chol_weight_record.assign(mcmc_step, chol_weight);
+		coef_record.assign(mcmc_step, coef_draw);
+		coef_dummy_record.assign(mcmc_step, coef_dummy);
+		coef_weight_record.assign(mcmc_step, coef_weight);
 	}
 	void doPosteriorDraws() {
 		std::lock_guard<std::mutex> lock(mtx);
@@ -149,29 +149,76 @@ public:
 		updateCoefDummy();
 		updateRecords();
 	}
-	Rcpp::List returnRecords(int num_burn, int thin) const {
-		Rcpp::List res = Rcpp::List::create(
-			Rcpp::Named("alpha_record") = coef_record,
-			Rcpp::Named("eta_record") = chol_upper_record,
-			Rcpp::Named("psi_record") = chol_diag_record,
-			Rcpp::Named("omega_record") = chol_dummy_record,
-			Rcpp::Named("gamma_record") = coef_dummy_record,
-			Rcpp::Named("chol_record") = chol_factor_record,
-			Rcpp::Named("p_record") = coef_weight_record,
-			Rcpp::Named("q_record") = chol_weight_record,
+	Rcpp::List returnRecords() const {
+		return Rcpp::List::create(
+			Rcpp::Named("alpha_record") = coef_record.returnRecord(mcmc_step),
+			Rcpp::Named("eta_record") = chol_upper_record.returnRecord(mcmc_step),
+			Rcpp::Named("psi_record") = chol_diag_record.returnRecord(mcmc_step),
+			Rcpp::Named("omega_record") = chol_dummy_record.returnRecord(mcmc_step),
+			Rcpp::Named("gamma_record") = coef_dummy_record.returnRecord(mcmc_step),
+			Rcpp::Named("chol_record") = chol_factor_record.returnRecord(mcmc_step),
+			Rcpp::Named("p_record") = coef_weight_record.returnRecord(mcmc_step),
+			Rcpp::Named("q_record") = chol_weight_record.returnRecord(mcmc_step),
 			Rcpp::Named("ols_coef") = coef_ols,
 			Rcpp::Named("ols_cholesky") = chol_ols
 		);
-		for (int i = 0; i < 8; i++) {
-			res[i] = thin_record(Rcpp::as<Eigen::MatrixXd>(res[i]), num_iter, num_burn, thin);
-		}
-		return res;
+	}
+	Eigen::MatrixXd returnCoefTrace(const Eigen::VectorXi& param_id) const {
+		return coef_record.returnTrace(mcmc_step, param_id);
+	}
+	// Checkpoint: parameters carried over to the next iteration, RNG, and records written so far
+	void saveState(std::ostream& os) const {
+		int step = mcmc_step;
+		write_state(os, step);
+		write_state(os, rng);
+		write_state(os, coef_draw);
+		write_state(os, coef_dummy);
+		write_state(os, coef_weight);
+		write_state(os, chol_diag);
+		write_state(os, chol_coef);
+		write_state(os, chol_dummy);
+		write_state(os, chol_weight);
+		write_state(os, chol_factor);
+		write_state(os, coef_mat);
+		write_state(os, sse_mat);
+		write_state(os, slab_weight_mat);
+		coef_record.saveRecord(os, step);
+		coef_dummy_record.saveRecord(os, step);
+		coef_weight_record.saveRecord(os, step);
+		chol_diag_record.saveRecord(os, step);
+		chol_upper_record.saveRecord(os, step);
+		chol_dummy_record.saveRecord(os, step);
+		chol_weight_record.saveRecord(os, step);
+		chol_factor_record.saveRecord(os, step);
+	}
+	void loadState(std::istream& is) {
+		int step;
+		read_state(is, step);
+		mcmc_step = step;
+		read_state(is, rng);
+		read_state(is, coef_draw);
+		read_state(is, coef_dummy);
+		read_state(is, coef_weight);
+		read_state(is, chol_diag);
+		read_state(is, chol_coef);
+		read_state(is, chol_dummy);
+		read_state(is, chol_weight);
+		read_state(is, chol_factor);
+		read_state(is, coef_mat);
+		read_state(is, sse_mat);
+		read_state(is, slab_weight_mat);
+		coef_record.loadRecord(is, step);
+		coef_dummy_record.loadRecord(is, step);
+		coef_weight_record.loadRecord(is, step);
+		chol_diag_record.loadRecord(is, step);
+		chol_upper_record.loadRecord(is, step);
+		chol_dummy_record.loadRecord(is, step);
+		chol_weight_record.loadRecord(is, step);
+		chol_factor_record.loadRecord(is, step);
 	}
 
 private:
 	int num_iter;
-	Eigen::MatrixXd x;
-	Eigen::MatrixXd y;
 	std::mutex mtx;
 	int dim; // k
 	int dim_design; // kp(+1)
@@ -203,18 +250,20 @@ private:
 	Eigen::VectorXd chol_mixture_mat;
 	Eigen::VectorXd slab_weight; // pij vector
 	Eigen::MatrixXd slab_weight_mat; // pij matrix: (dim*p) x dim
-	Eigen::MatrixXd gram;
+	Eigen::MatrixXd gram; // X0^T X0
+	Eigen::MatrixXd xty; // X0^T Y0
+	Eigen::MatrixXd yty; // Y0^T Y0
 	Eigen::MatrixXd coef_ols;
 	Eigen::VectorXd coef_vec;
 	Eigen::MatrixXd chol_ols;
-	Eigen::MatrixXd coef_record;
-	Eigen::MatrixXd coef_dummy_record;
-	Eigen::MatrixXd coef_weight_record;
-	Eigen::MatrixXd chol_diag_record;
-	Eigen::MatrixXd chol_upper_record;
-	Eigen::MatrixXd chol_dummy_record;
-	Eigen::MatrixXd chol_weight_record;
-	Eigen::MatrixXd chol_factor_record; // 3d matrix alternative
+	McmcRecord coef_record;
+	McmcRecord coef_dummy_record;
+	McmcRecord coef_weight_record;
+	McmcRecord chol_diag_record;
+	McmcRecord chol_upper_record;
+	McmcRecord chol_dummy_record;
+	McmcRecord chol_weight_record;
+	McmcRecord chol_factor_record; // 3d matrix alternative
 	Eigen::VectorXd coef_weight;
 	Eigen::VectorXd chol_weight;
 	Eigen::VectorXd coef_draw;
@@ -225,6 +274,11 @@ private:
 	Eigen::MatrixXd chol_factor;
 	Eigen::MatrixXd coef_mat;
 	Eigen::MatrixXd sse_mat;
+	// (Y0 - X0 A)^T (Y0 - X0 A) from the sufficient statistics, so no step after construction depends on n
+	Eigen::MatrixXd computeSse(const Eigen::MatrixXd& coef) const {
+		Eigen::MatrixXd cross = coef.transpose() * xty; // A^T X0^T Y0
+		return yty - cross - cross.transpose() + coef.transpose() * gram * coef;
+	}
 };
 
 } // namespace bvhar
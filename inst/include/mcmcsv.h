@@ -3,14 +3,23 @@
 
 #include "bvhardesign.h"
 #include "bvhardraw.h"
+#include "bvharfixed.h"
 #include "bvharprogress.h"
+#include "bvharcheckpoint.h"
+#include "bvhartimer.h"
+#include "bvharrecord.h"
 
 namespace bvhar {
 
+// Data are referenced, not copied:
+// every chain reads the same X0 and Y0, which must outlive the chains (as the R inputs do).
 struct SvParams {
 	int _iter;
-	Eigen::MatrixXd _x;
-	Eigen::MatrixXd _y;
+	int _burn;
+	int _thin;
+	SummarySpec _summary;
+	Eigen::Ref<const Eigen::MatrixXd> _x;
+	Eigen::Ref<const Eigen::MatrixXd> _y;
 	Eigen::VectorXd _sig_shp;
 	Eigen::VectorXd _sig_scl;
 	Eigen::VectorXd _init_mean;
@@ -18,19 +27,21 @@ struct SvParams {
 	Eigen::VectorXd _mean_non;
 	double _sd_non;
 	bool _mean;
+	int _num_factor; // q > 0 replaces the Cholesky structure with q latent SV factors
 
 	SvParams(
-		int num_iter, const Eigen::MatrixXd& x, const Eigen::MatrixXd& y,
+		int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, const Eigen::Ref<const Eigen::MatrixXd>& x, const Eigen::Ref<const Eigen::MatrixXd>& y,
 		Rcpp::List& spec, Rcpp::List& intercept,
 		bool include_mean
 	)
-	: _iter(num_iter), _x(x), _y(y),
+	: _iter(num_iter), _burn(num_burn), _thin(thin), _summary(summary_spec), _x(x), _y(y),
 		_sig_shp(Rcpp::as<Eigen::VectorXd>(spec["shape"])),
 		_sig_scl(Rcpp::as<Eigen::VectorXd>(spec["scale"])),
 		_init_mean(Rcpp::as<Eigen::VectorXd>(spec["initial_mean"])),
 		_init_prec(Rcpp::as<Eigen::MatrixXd>(spec["initial_prec"])),
 		_mean_non(Rcpp::as<Eigen::VectorXd>(intercept["mean_non"])),
-		_sd_non(intercept["sd_non"]), _mean(include_mean) {}
+		_sd_non(intercept["sd_non"]), _mean(include_mean),
+		_num_factor(spec.containsElementNamed("num_factor") ? Rcpp::as<int>(spec["num_factor"]) : 0) {}
 };
 
 struct MinnParams : public SvParams {
@@ -39,11 +50,11 @@ struct MinnParams : public SvParams {
 	Eigen::MatrixXd _prior_prec;
 
 	MinnParams(
-		int num_iter, const Eigen::MatrixXd& x, const Eigen::MatrixXd& y,
+		int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, const Eigen::Ref<const Eigen::MatrixXd>& x, const Eigen::Ref<const Eigen::MatrixXd>& y,
 		Rcpp::List& sv_spec, Rcpp::List& priors, Rcpp::List& intercept,
 		bool include_mean
 	)
-	: SvParams(num_iter, x, y, sv_spec, intercept, include_mean),
+	: SvParams(num_iter, num_burn, thin, summary_spec, x, y, sv_spec, intercept, include_mean),
 		_prec_diag(Eigen::MatrixXd::Zero(y.cols(), y.cols())) {
 		int lag = priors["p"]; // append to bayes_spec, p = 3 in VHAR
 		Eigen::VectorXd _sigma = Rcpp::as<Eigen::VectorXd>(priors["sigma"]);
@@ -89,13 +100,13 @@ struct SsvsParams : public SvParams {
 	double _contem_s2;
 
 	SsvsParams(
-		int num_iter, const Eigen::MatrixXd& x, const Eigen::MatrixXd& y,
+		int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, const Eigen::Ref<const Eigen::MatrixXd>& x, const Eigen::Ref<const Eigen::MatrixXd>& y,
 		Rcpp::List& sv_spec,
 		const Eigen::VectorXi& grp_id, const Eigen::MatrixXi& grp_mat,
 		Rcpp::List& ssvs_spec, Rcpp::List& intercept,
 		bool include_mean
 	)
-	: SvParams(num_iter, x, y, sv_spec, intercept, include_mean),
+	: SvParams(num_iter, num_burn, thin, summary_spec, x, y, sv_spec, intercept, include_mean),
 		_grp_id(grp_id), _grp_mat(grp_mat),
 		_coef_spike(Rcpp::as<Eigen::VectorXd>(ssvs_spec["coef_spike"])),
 		_coef_slab(Rcpp::as<Eigen::VectorXd>(ssvs_spec["coef_slab"])),
@@ -112,12 +123,12 @@ struct HorseshoeParams : public SvParams {
 	Eigen::MatrixXi _grp_mat;
 
 	HorseshoeParams(
-		int num_iter, const Eigen::MatrixXd& x, const Eigen::MatrixXd& y,
+		int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, const Eigen::Ref<const Eigen::MatrixXd>& x, const Eigen::Ref<const Eigen::MatrixXd>& y,
 		Rcpp::List& sv_spec,
 		const Eigen::VectorXi& grp_id, const Eigen::MatrixXi& grp_mat,
 		Rcpp::List& intercept, bool include_mean
 	)
-	: SvParams(num_iter, x, y, sv_spec, intercept, include_mean), _grp_id(grp_id), _grp_mat(grp_mat) {}
+	: SvParams(num_iter, num_burn, thin, summary_spec, x, y, sv_spec, intercept, include_mean), _grp_id(grp_id), _grp_mat(grp_mat) {}
 };
 
 struct SvInits {
@@ -130,12 +141,14 @@ struct SvInits {
 	SvInits(const SvParams& params) {
 		_coef = (params._x.transpose() * params._x).llt().solve(params._x.transpose() * params._y); // OLS
 		int dim = params._y.cols();
-		int num_lowerchol = dim * (dim - 1) / 2;
+		int num_factor = params._num_factor;
+		int num_lowerchol = num_factor > 0 ? dim * num_factor - num_factor * (num_factor + 1) / 2 : dim * (dim - 1) / 2;
 		int num_design = params._y.rows();
 		_contem = .001 * Eigen::VectorXd::Zero(num_lowerchol);
-		_lvol_init = (params._y - params._x * _coef).transpose().array().square().rowwise().mean().log();
+		_lvol_init = Eigen::VectorXd::Zero(dim + num_factor);
+		_lvol_init.head(dim) = (params._y - params._x * _coef).transpose().array().square().rowwise().mean().log();
 		_lvol = _lvol_init.transpose().replicate(num_design, 1);
-		_lvol_sig = .1 * Eigen::VectorXd::Ones(dim);
+		_lvol_sig = .1 * Eigen::VectorXd::Ones(dim + num_factor);
 	}
 	SvInits(Rcpp::List& init)
 	: _coef(Rcpp::as<Eigen::MatrixXd>(init["init_coef"])),
@@ -171,65 +184,138 @@ struct HorseshoeInits : public SvInits {
 		_init_conetm_global(Rcpp::as<Eigen::VectorXd>(init["contem_global_sparsity"])) {}
 };
 
+// Records of retained draws, in R memory (see McmcRecord)
 struct SvRecords {
-	Eigen::MatrixXd coef_record; // alpha in VAR
-	Eigen::MatrixXd contem_coef_record; // a = a21, a31, a32, ..., ak1, ..., ak(k-1)
-	Eigen::MatrixXd lvol_sig_record; // sigma_h^2 = (sigma_(h1i)^2, ..., sigma_(hki)^2)
-	Eigen::MatrixXd lvol_init_record; // h0 = h10, ..., hk0
-	Eigen::MatrixXd lvol_record; // time-varying h = (h_1, ..., h_k) with h_j = (h_j1, ..., h_jn), row-binded
+	McmcRecord coef_record; // alpha in VAR
+	McmcRecord c_record; // constant term
+	McmcRecord contem_coef_record; // a = a21, a31, a32, ..., ak1, ..., ak(k-1)
+	McmcRecord lvol_sig_record; // sigma_h^2 = (sigma_(h1i)^2, ..., sigma_(hki)^2)
+	McmcRecord lvol_init_record; // h0 = h10, ..., hk0
+	McmcRecord lvol_record; // time-varying h = (h_1, ..., h_k) with h_j = (h_j1, ..., h_jn), row-binded
 
-	SvRecords(int num_iter, int dim, int num_design, int num_coef, int num_lowerchol)
-	: coef_record(Eigen::MatrixXd::Zero(num_iter + 1, num_coef)),
-		contem_coef_record(Eigen::MatrixXd::Zero(num_iter + 1, num_lowerchol)),
-		lvol_sig_record(Eigen::MatrixXd::Ones(num_iter + 1, dim)),
-		lvol_init_record(Eigen::MatrixXd::Zero(num_iter + 1, dim)),
-		lvol_record(Eigen::MatrixXd::Zero(num_iter + 1, num_design * dim)) {}
+	SvRecords(int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, int dim, int num_design, int num_alpha, int num_mean, int num_lowerchol)
+	: coef_record(num_iter, num_burn, thin, num_alpha, summary_spec),
+		c_record(num_iter, num_burn, thin, num_mean, summary_spec),
+		contem_coef_record(num_iter, num_burn, thin, num_lowerchol, summary_spec),
+		lvol_sig_record(num_iter, num_burn, thin, dim, summary_spec),
+		lvol_init_record(num_iter, num_burn, thin, dim, summary_spec),
+		lvol_record(num_iter, num_burn, thin, num_design * dim, summary_spec) {}
 	void assignRecords(
 		int id,
 		const Eigen::VectorXd& coef_vec, const Eigen::VectorXd& contem_coef,
 		const Eigen::MatrixXd& lvol_draw, const Eigen::VectorXd& lvol_sig, const Eigen::VectorXd& lvol_init
 	) {
-		coef_record.row(id) = coef_vec;
-		contem_coef_record.row(id) = contem_coef;
-		// lvol_record.row(id) = vectorize_eigen(lvol_draw.transpose().eval());
-		lvol_record.row(id) = lvol_draw.transpose().reshaped();
-		lvol_sig_record.row(id) = lvol_sig;
-		lvol_init_record.row(id) = lvol_init;
+		coef_record.assign(id, coef_vec.head(coef_record.cols()));
+		c_record.assign(id, coef_vec.tail(c_record.cols()));
+		contem_coef_record.assign(id, contem_coef);
+		lvol_record.assign(id, lvol_draw.transpose().reshaped());
+		lvol_sig_record.assign(id, lvol_sig);
+		lvol_init_record.assign(id, lvol_init);
+	}
+	// Retained draws of [alpha, c] in chosen columns
+	Eigen::MatrixXd returnCoefTrace(int step, const Eigen::VectorXi& col_id) const {
+		int num_alpha = coef_record.cols();
+		int num_row = coef_record.numKept(step);
+		if (col_id.size() == 0) {
+			Eigen::MatrixXd res(num_row, num_alpha + c_record.cols());
+			res << coef_record.returnTrace(step, col_id), c_record.returnTrace(step, col_id);
+			return res;
+		}
+		Eigen::MatrixXd res(num_row, col_id.size());
+		for (int j = 0; j < col_id.size(); j++) {
+			if (col_id[j] < num_alpha) {
+				res.col(j) = coef_record.getRecord().col(col_id[j]).head(num_row);
+			} else {
+				res.col(j) = c_record.getRecord().col(col_id[j] - num_alpha).head(num_row);
+			}
+		}
+		return res;
+	}
+	void saveRecords(std::ostream& os, int step) const {
+		coef_record.saveRecord(os, step);
+		c_record.saveRecord(os, step);
+		contem_coef_record.saveRecord(os, step);
+		lvol_sig_record.saveRecord(os, step);
+		lvol_init_record.saveRecord(os, step);
+		lvol_record.saveRecord(os, step);
+	}
+	void loadRecords(std::istream& is, int step) {
+		coef_record.loadRecord(is, step);
+		c_record.loadRecord(is, step);
+		contem_coef_record.loadRecord(is, step);
+		lvol_sig_record.loadRecord(is, step);
+		lvol_init_record.loadRecord(is, step);
+		lvol_record.loadRecord(is, step);
+	}
+	Rcpp::List returnRecords(int step, bool include_mean) const {
+		Rcpp::List res = Rcpp::List::create(
+			Rcpp::Named("alpha_record") = coef_record.returnRecord(step),
+			Rcpp::Named("h_record") = lvol_record.returnRecord(step),
+			Rcpp::Named("a_record") = contem_coef_record.returnRecord(step),
+			Rcpp::Named("h0_record") = lvol_init_record.returnRecord(step),
+			Rcpp::Named("sigh_record") = lvol_sig_record.returnRecord(step)
+		);
+		if (include_mean) {
+			res["c_record"] = c_record.returnRecord(step);
+		}
+		return res;
 	}
 };
 
 struct SsvsRecords {
-	Eigen::MatrixXd coef_dummy_record;
-	Eigen::MatrixXd coef_weight_record;
-	Eigen::MatrixXd contem_dummy_record;
-	Eigen::MatrixXd contem_weight_record;
+	McmcRecord coef_dummy_record;
+	McmcRecord coef_weight_record;
+	McmcRecord contem_dummy_record;
+	McmcRecord contem_weight_record;
 
-	SsvsRecords(int num_iter, int num_alpha, int num_grp, int num_lowerchol)
-	: coef_dummy_record(Eigen::MatrixXd::Ones(num_iter + 1, num_alpha)),
-		coef_weight_record(Eigen::MatrixXd::Zero(num_iter + 1, num_grp)),
-		contem_dummy_record(Eigen::MatrixXd::Ones(num_iter + 1, num_lowerchol)),
-		contem_weight_record(Eigen::MatrixXd::Zero(num_iter + 1, num_lowerchol)) {}
+	SsvsRecords(int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, int num_alpha, int num_grp, int num_lowerchol)
+	: coef_dummy_record(num_iter, num_burn, thin, num_alpha, summary_spec, true),
+		coef_weight_record(num_iter, num_burn, thin, num_grp, summary_spec),
+		contem_dummy_record(num_iter, num_burn, thin, num_lowerchol, summary_spec, true),
+		contem_weight_record(num_iter, num_burn, thin, num_lowerchol, summary_spec) {}
 	void assignRecords(int id, const Eigen::VectorXd& coef_dummy, const Eigen::VectorXd& coef_weight, const Eigen::VectorXd& contem_dummy, const Eigen::VectorXd& contem_weight) {
-		coef_dummy_record.row(id) = coef_dummy;
-		coef_weight_record.row(id) = coef_weight;
-		contem_dummy_record.row(id) = contem_dummy;
-		contem_weight_record.row(id) = contem_weight;
+		coef_dummy_record.assign(id, coef_dummy);
+		coef_weight_record.assign(id, coef_weight);
+		contem_dummy_record.assign(id, contem_dummy);
+		contem_weight_record.assign(id, contem_weight);
+	}
+	void saveRecords(std::ostream& os, int step) const {
+		coef_dummy_record.saveRecord(os, step);
+		coef_weight_record.saveRecord(os, step);
+		contem_dummy_record.saveRecord(os, step);
+		contem_weight_record.saveRecord(os, step);
+	}
+	void loadRecords(std::istream& is, int step) {
+		coef_dummy_record.loadRecord(is, step);
+		coef_weight_record.loadRecord(is, step);
+		contem_dummy_record.loadRecord(is, step);
+		contem_weight_record.loadRecord(is, step);
 	}
 };
 
 struct HorseshoeRecords {
-	Eigen::MatrixXd local_record;
-	Eigen::MatrixXd global_record;
-	Eigen::MatrixXd shrink_record;
+	McmcRecord local_record;
+	McmcRecord global_record;
+	McmcRecord shrink_record;
 
-	HorseshoeRecords(int num_iter, int num_alpha, int num_grp, int num_lowerchol)
-	: local_record(Eigen::MatrixXd::Zero(num_iter + 1, num_alpha)),
-		global_record(Eigen::MatrixXd::Zero(num_iter + 1, num_grp)),
-		shrink_record(Eigen::MatrixXd::Zero(num_iter + 1, num_alpha)) {}
+	HorseshoeRecords(int num_iter, int num_burn, int thin, const SummarySpec& summary_spec, int num_alpha, int num_grp)
+	: local_record(num_iter, num_burn, thin, num_alpha, summary_spec),
+		global_record(num_iter, num_burn, thin, num_grp, summary_spec),
+		shrink_record(num_iter, num_burn, thin, num_alpha, summary_spec) {}
 	void assignRecords(int id, const Eigen::VectorXd& shrink_fac, const Eigen::VectorXd& local_lev, const Eigen::VectorXd& global_lev) {
-		shrink_record.row(id) = shrink_fac;
-		local_record.row(id) = local_lev;
-		global_record.row(id) = global_lev;
+		shrink_record.assign(id, shrink_fac);
+		local_record.assign(id, local_lev);
+		global_record.assign(id, global_lev);
+	}
+	void saveRecords(std::ostream& os, int step) const {
+		local_record.saveRecord(os, step);
+		global_record.saveRecord(os, step);
+		shrink_record.saveRecord(os, step);
+	}
+	void loadRecords(std::istream& is, int step) {
+		local_record.loadRecord(is, step);
+		global_record.loadRecord(is, step);
+		shrink_record.loadRecord(is, step);
 	}
 };
 
@@ -238,11 +324,13 @@ public:
 	McmcSv(const SvParams& params, const SvInits& inits, unsigned int seed)
 	: include_mean(params._mean),
 		x(params._x), y(params._y),
-		num_iter(params._iter), dim(y.cols()), dim_design(x.cols()), num_design(y.rows()),
-		num_lowerchol(dim * (dim - 1) / 2), num_coef(dim * dim_design),
-		num_alpha(include_mean ? num_coef - dim : num_coef),
-		sv_record(num_iter, dim, num_design, num_coef, num_lowerchol),
-		mcmc_step(0), rng(seed),
+		num_iter(params._iter), num_burn(params._burn), thin(params._thin), dim(y.cols()), dim_design(x.cols()), num_design(y.rows()),
+		num_factor(params._num_factor),
+		num_lowerchol(num_factor > 0 ? dim * num_factor - num_factor * (num_factor + 1) / 2 : dim * (dim - 1) / 2),
+		num_coef(dim * dim_design),
+		num_alpha(include_mean ? num_coef - dim : num_coef), num_lvol(dim + num_factor),
+		sv_record(num_iter, num_burn, thin, params._summary, num_lvol, num_design, num_alpha, num_coef - num_alpha, num_lowerchol),
+		mcmc_step(0), rng(seed), nthreads_intra(1), stage_timer(NUM_STAGE),
 		prior_mean_non(params._mean_non),
 		prior_sd_non(params._sd_non * Eigen::VectorXd::Ones(dim)),
 		coef_vec(Eigen::VectorXd::Zero(num_coef)),
@@ -253,15 +341,17 @@ public:
 		prior_chol_mean(Eigen::VectorXd::Zero(num_lowerchol)),
 		prior_chol_prec(Eigen::MatrixXd::Identity(num_lowerchol, num_lowerchol)),
 		coef_mat(inits._coef),
-		contem_id(0),
-		chol_lower(build_inv_lower(dim, contem_coef)),
+		chol_lower(num_factor > 0 ? Eigen::MatrixXd(Eigen::MatrixXd::Identity(dim, dim)) : build_inv_lower(dim, contem_coef)),
+		factor_draw(Eigen::MatrixXd::Zero(num_design, num_factor)),
+		loading_mat(build_factor_loading(dim, num_factor, contem_coef)),
+		is_structural(false),
+		struct_coef(coef_mat * chol_lower.transpose()),
+		struct_vec(Eigen::VectorXd::Zero(num_coef)),
 		latent_innov(y - x * coef_mat),
-		ortho_latent(Eigen::MatrixXd::Zero(num_design, dim)),
+		ortho_latent(Eigen::MatrixXd::Zero(num_design, num_lvol)),
 		prior_mean_j(Eigen::VectorXd::Zero(dim_design)),
 		prior_prec_j(Eigen::MatrixXd::Identity(dim_design, dim_design)),
-		coef_j(coef_mat),
-		response_contem(Eigen::VectorXd::Zero(num_design)),
-		sqrt_sv(Eigen::MatrixXd::Zero(num_design, dim)),
+		sqrt_sv(Eigen::MatrixXd::Zero(num_design, num_lvol)),
 		prior_sig_shp(params._sig_shp), prior_sig_scl(params._sig_scl),
 		prior_init_mean(params._init_mean), prior_init_prec(params._init_prec) {
 		if (include_mean) {
@@ -273,15 +363,20 @@ public:
 		if (include_mean) {
 			coef_vec.tail(dim) = coef_mat.bottomRows(1).transpose();
 		}
+		updateStructVec();
 		sv_record.assignRecords(0, coef_vec, contem_coef, lvol_draw, lvol_sig, lvol_init);
+		for (int i = 0; i < num_lvol; i++) {
+			task_rng.emplace_back(rng());
+		}
 	}
 	virtual ~McmcSv() = default;
+	// latent_innov is kept at Y0 - X0 A while each column is drawn:
+	// Y0 - X0 A(-j) differs from it only in the j-th column, which is Y0 column itself.
 	void updateCoef() {
 		for (int j = 0; j < dim; j++) {
 			prior_mean_j = prior_alpha_mean.segment(dim_design * j, dim_design);
 			prior_prec_j = prior_alpha_prec.block(dim_design * j, dim_design * j, dim_design, dim_design);
-			coef_j = coef_mat;
-			coef_j.col(j).setZero();
+			latent_innov.col(j) = y.col(j); // Y0 - X0 A(-j)
 			Eigen::MatrixXd chol_lower_j = chol_lower.bottomRows(dim - j); // L_(j:k) = a_jt to a_kt for t = 1, ..., j - 1
 			Eigen::MatrixXd sqrt_sv_j = sqrt_sv.rightCols(dim - j); // use h_jt to h_kt for t = 1, .. n => (k - j + 1) x k
 			// Eigen::MatrixXd design_coef = kronecker_eigen(chol_lower_j.col(j), x).array().colwise() * vectorize_eigen(sqrt_sv_j).array(); // L_(j:k, j) otimes X0 scaled by D_(1:n, j:k): n(k - j + 1) x kp
@@ -289,13 +384,14 @@ public:
 			// Eigen::VectorXd response_j = vectorize_eigen(
 			// 	(((y - x * coef_j) * chol_lower_j.transpose()).array() * sqrt_sv_j.array()).matrix().eval() // Hadamard product between: (Y - X0 A(-j))L_(j:k)^T and D_(1:n, j:k)
 			// ); // Response vector of j-th column coef equation: n(k - j + 1)-dim
-			Eigen::VectorXd response_j = (((y - x * coef_j) * chol_lower_j.transpose()).array() * sqrt_sv_j.array()).reshaped(); // Hadamard product between: (Y - X0 A(-j))L_(j:k)^T and D_(1:n, j:k)
+			Eigen::VectorXd response_j = ((latent_innov * chol_lower_j.transpose()).array() * sqrt_sv_j.array()).reshaped(); // Hadamard product between: (Y - X0 A(-j))L_(j:k)^T and D_(1:n, j:k)
 			varsv_regression(
 				coef_mat.col(j),
 				design_coef, response_j,
 				prior_mean_j, prior_prec_j,
 				rng
 			);
+			latent_innov.col(j).noalias() = y.col(j) - x * coef_mat.col(j); // back to Y0 - X0 A with the new column
 		}
 		// coef_vec.head(num_alpha) = vectorize_eigen(coef_mat.topRows(num_alpha / dim).eval());
 		coef_vec.head(num_alpha) = coef_mat.topRows(num_alpha / dim).reshaped();
@@ -303,26 +399,208 @@ public:
 			coef_vec.tail(dim) = coef_mat.bottomRows(1).transpose();
 		}
 	}
-	void updateState() {
-		ortho_latent = latent_innov * chol_lower.transpose(); // L eps_t <=> Z0 U
+	// Structural form
+	//
+	// L (y_t - A^T x_t) = u_t gives y_jt = Gamma_j^T x_t - a_j^T (y_1t, ..., y_(j-1)t) + u_jt with Gamma = A L^T.
+	// Given h, the k equations are conditionally independent, so each draws [Gamma_j, -a_j] in one regression
+	// on its own thread and RNG substream. The priors of A and a apply to Gamma and a,
+	// and A = Gamma L^(-T) keeps the reduced-form records.
+	void setStructural(bool structural) {
+		is_structural = structural;
+	}
+	void updateStructural() {
+	#ifdef _OPENMP
+		#pragma omp parallel for num_threads(nthreads_intra) if(nthreads_intra > 1)
+	#endif
+		for (int j = 0; j < dim; j++) {
+			int contem_id = j * (j - 1) / 2;
+			int num_struct = dim_design + j;
+			Eigen::MatrixXd design_struct(num_design, num_struct); // [X0, y_1, ..., y_(j-1)] scaled by exp(-h_j / 2)
+			design_struct.leftCols(dim_design) = x;
+			design_struct.rightCols(j) = y.leftCols(j);
+			design_struct.array().colwise() *= sqrt_sv.col(j).array();
+			Eigen::VectorXd response_struct = y.col(j).cwiseProduct(sqrt_sv.col(j));
+			Eigen::VectorXd prior_mean_struct(num_struct);
+			prior_mean_struct.head(dim_design) = prior_alpha_mean.segment(dim_design * j, dim_design);
+			prior_mean_struct.tail(j) = -prior_chol_mean.segment(contem_id, j);
+			Eigen::MatrixXd prior_prec_struct = Eigen::MatrixXd::Zero(num_struct, num_struct);
+			prior_prec_struct.topLeftCorner(dim_design, dim_design) = prior_alpha_prec.block(dim_design * j, dim_design * j, dim_design, dim_design);
+			prior_prec_struct.bottomRightCorner(j, j) = prior_chol_prec.block(contem_id, contem_id, j, j);
+			Eigen::VectorXd struct_draw(num_struct);
+			varsv_regression(struct_draw, design_struct, response_struct, prior_mean_struct, prior_prec_struct, task_rng[j]);
+			struct_coef.col(j) = struct_draw.head(dim_design);
+			contem_coef.segment(contem_id, j) = -struct_draw.tail(j);
+		}
+		chol_lower = build_inv_lower(dim, contem_coef);
+		coef_mat = chol_lower.triangularView<Eigen::UnitLower>().solve(struct_coef.transpose()).transpose(); // A^T = L^(-1) Gamma^T
+		latent_innov = y - x * coef_mat;
+		coef_vec.head(num_alpha) = coef_mat.topRows(num_alpha / dim).reshaped();
+		if (include_mean) {
+			coef_vec.tail(dim) = coef_mat.bottomRows(1).transpose();
+		}
+		updateStructVec();
+	}
+	// Coefficients and contemporaneous coefficients (or loadings) of one sweep in either form
+	void updateCoefImpact() {
+		if (num_factor > 0) {
+			updateFactorCoef();
+			stage_timer.lap(COEF);
+			updateCoefShrink();
+			stage_timer.lap(COEF_SHRINK);
+			updateImpactPrec();
+			stage_timer.lap(IMPACT_PREC);
+			updateLoading();
+			stage_timer.lap(IMPACT);
+			return;
+		}
+		if (is_structural) {
+			updateImpactPrec();
+			stage_timer.lap(IMPACT_PREC);
+			updateStructural();
+			stage_timer.lap(COEF);
+			updateCoefShrink();
+			stage_timer.lap(COEF_SHRINK);
+			return;
+		}
+		updateCoef();
+		stage_timer.lap(COEF);
+		updateCoefShrink();
+		stage_timer.lap(COEF_SHRINK);
+		updateImpactPrec();
+		stage_timer.lap(IMPACT_PREC);
+		updateImpact(); // E_t already follows the new coef
+		stage_timer.lap(IMPACT);
+	}
+	// Factor structure
+	//
+	// eps_t = Lambda f_t + e_t with f_lt ~ N(0, exp(g_lt)) and e_jt ~ N(0, exp(h_jt)),
+	// so the k + q log-volatilities are stacked in lvol_draw as (h_1t, ..., h_kt, g_1t, ..., g_qt).
+	// Given the factors, the equations are independent in both A and Lambda,
+	// and every covariance update costs O(nkq^2) instead of O(nk^3).
+	// The free loadings take the place of a, so the priors on a apply to them.
+	void updateFactorCoef() {
+		Eigen::MatrixXd factor_resid = y - factor_draw * loading_mat.transpose(); // Y0 - F Lambda^T
+	#ifdef _OPENMP
+		#pragma omp parallel for num_threads(nthreads_intra) if(nthreads_intra > 1)
+	#endif
+		for (int j = 0; j < dim; j++) {
+			Eigen::MatrixXd design_coef = x.array().colwise() * sqrt_sv.col(j).array(); // X0 scaled by exp(-h_j / 2)
+			Eigen::VectorXd response_j = factor_resid.col(j).cwiseProduct(sqrt_sv.col(j));
+			varsv_regression(
+				coef_mat.col(j),
+				design_coef, response_j,
+				prior_alpha_mean.segment(dim_design * j, dim_design),
+				prior_alpha_prec.block(dim_design * j, dim_design * j, dim_design, dim_design),
+				task_rng[j]
+			);
+		}
+		latent_innov = y - x * coef_mat;
+		coef_vec.head(num_alpha) = coef_mat.topRows(num_alpha / dim).reshaped();
+		if (include_mean) {
+			coef_vec.tail(dim) = coef_mat.bottomRows(1).transpose();
+		}
+	}
+	// Each row of L, or of the free loadings, has at most k - 1 coefficients,
+	// so for small k its regression keeps every k x k temporary on the stack.
+	void updateLowerRow(Eigen::Ref<Eigen::VectorXd> lower_row, Eigen::MatrixXd& x, Eigen::VectorXd& y, int lower_id, boost::random::mt19937& lower_rng) {
+		int num_free = lower_row.size();
+		if (num_free <= max_fixed_dim) {
+			varsv_regression<max_fixed_dim>(
+				lower_row, x, y,
+				prior_chol_mean.segment(lower_id, num_free), prior_chol_prec.block(lower_id, lower_id, num_free, num_free),
+				lower_rng
+			);
+		} else {
+			varsv_regression(
+				lower_row, x, y,
+				prior_chol_mean.segment(lower_id, num_free), prior_chol_prec.block(lower_id, lower_id, num_free, num_free),
+				lower_rng
+			);
+		}
+	}
+	void updateLoading() {
+	#ifdef _OPENMP
+		#pragma omp parallel for num_threads(nthreads_intra) if(nthreads_intra > 1)
+	#endif
+		for (int j = 1; j < dim; j++) {
+			int num_free = std::min(j, num_factor);
+			int loading_id = j <= num_factor ? j * (j - 1) / 2 : num_factor * (num_factor - 1) / 2 + (j - num_factor) * num_factor;
+			Eigen::VectorXd response_loading = latent_innov.col(j);
+			if (j < num_factor) {
+				response_loading -= factor_draw.col(j); // unit loading
+			}
+			response_loading.array() *= sqrt_sv.col(j).array();
+			Eigen::MatrixXd design_loading = factor_draw.leftCols(num_free).array().colwise() * sqrt_sv.col(j).array();
+			updateLowerRow(contem_coef.segment(loading_id, num_free), design_loading, response_loading, loading_id, task_rng[j]);
+		}
+		loading_mat = build_factor_loading(dim, num_factor, contem_coef);
+	}
+	// f_t | - ~ N(P_t^(-1) Lambda^T D_t^(-1) eps_t, P_t^(-1)) with P_t = V_t^(-1) + Lambda^T D_t^(-1) Lambda
+	void updateFactor() {
+		Eigen::VectorXd std_norm(num_factor);
+		for (int t = 0; t < num_design; t++) {
+			Eigen::MatrixXd weighted_loading = loading_mat.array().colwise() * sqrt_sv.row(t).head(dim).transpose().array(); // D_t^(-1/2) Lambda
+			Eigen::MatrixXd factor_prec = weighted_loading.transpose() * weighted_loading;
+			factor_prec.diagonal() += sqrt_sv.row(t).tail(num_factor).transpose().array().square().matrix();
+			Eigen::LLT<Eigen::MatrixXd> llt_factor(factor_prec);
+			Eigen::VectorXd factor_mean = llt_factor.solve(
+				weighted_loading.transpose() * latent_innov.row(t).transpose().cwiseProduct(sqrt_sv.row(t).head(dim).transpose())
+			);
+			for (int i = 0; i < num_factor; i++) {
+				std_norm[i] = normal_rand(rng);
+			}
+			factor_draw.row(t) = (factor_mean + llt_factor.matrixU().solve(std_norm)).transpose();
+		}
+	}
+	// Intra-chain parallelism
+	//
+	// With more than one thread, per-variable updates of h and a (or structural equations) are distributed over threads.
+	// Each variable draws from its own RNG substream seeded by the chain RNG,
+	// so the draws do not depend on the number of threads.
+	void setIntraThreads(int num_thread) {
+		nthreads_intra = num_thread;
+	}
+	// Stages of doPosteriorDraws() measured by the timer
+	static std::vector<std::string> stageNames() {
+		return {"coef_prec", "coef", "coef_shrink", "impact_prec", "impact", "state", "state_var", "init_state", "records"};
+	}
+	void setTiming(bool timing) {
+		stage_timer.setActive(timing);
+	}
+	// Seconds spent in each stage so far
+	Eigen::VectorXd returnTiming() const {
+		return stage_timer.returnTime();
+	}
+	// Auxiliary residuals of log-volatilities: log((L eps_t)^2 + c), or of (e_t, f_t) in factor structure
+	void updateStateResid() {
+		if (num_factor > 0) {
+			updateFactor();
+			ortho_latent.leftCols(dim) = latent_innov - factor_draw * loading_mat.transpose(); // e_t = eps_t - Lambda f_t
+			ortho_latent.rightCols(num_factor) = factor_draw;
+		} else {
+			chol_lower = build_inv_lower(dim, contem_coef); // L before h_t
+			ortho_latent = latent_innov * chol_lower.transpose(); // L eps_t <=> Z0 U
+		}
 		ortho_latent = (ortho_latent.array().square() + .0001).array().log(); // adjustment log(e^2 + c) for some c = 10^(-4) against numerical problems
-		for (int t = 0; t < dim; t++) {
-			varsv_ht(lvol_draw.col(t), lvol_init[t], lvol_sig[t], ortho_latent.col(t), rng);
+	}
+	void updateState() {
+		updateStateResid();
+	#ifdef _OPENMP
+		#pragma omp parallel for num_threads(nthreads_intra) if(nthreads_intra > 1)
+	#endif
+		for (int t = 0; t < num_lvol; t++) {
+			varsv_ht(lvol_draw.col(t), lvol_init[t], lvol_sig[t], ortho_latent.col(t), task_rng[t]);
 		}
 	}
 	void updateImpact() {
+	#ifdef _OPENMP
+		#pragma omp parallel for num_threads(nthreads_intra) if(nthreads_intra > 1)
+	#endif
 		for (int j = 2; j < dim + 1; j++) {
-			response_contem = latent_innov.col(j - 2).array() * sqrt_sv.col(j - 2).array(); // n-dim
-			// Eigen::MatrixXd design_contem = latent_innov.leftCols(j - 1).array().colwise() * vectorize_eigen(sqrt_sv.col(j - 2).eval()).array(); // n x (j - 1)
+			Eigen::VectorXd response_contem = latent_innov.col(j - 2).array() * sqrt_sv.col(j - 2).array(); // n-dim
 			Eigen::MatrixXd design_contem = latent_innov.leftCols(j - 1).array().colwise() * sqrt_sv.col(j - 2).reshaped().array(); // n x (j - 1)
-			contem_id = (j - 1) * (j - 2) / 2;
-			varsv_regression(
-				contem_coef.segment(contem_id, j - 1),
-				design_contem, response_contem,
-				prior_chol_mean.segment(contem_id, j - 1),
-				prior_chol_prec.block(contem_id, contem_id, j - 1, j - 1),
-				rng
-			);
+			int contem_id = (j - 1) * (j - 2) / 2;
+			updateLowerRow(contem_coef.segment(contem_id, j - 1), design_contem, response_contem, contem_id, task_rng[j - 1]);
 		}
 	}
 	void updateStateVar() { varsv_sigh(lvol_sig, prior_sig_shp, prior_sig_scl, lvol_init, lvol_draw, rng); }
@@ -332,24 +610,144 @@ public:
 	virtual void updateCoefShrink() = 0;
 	virtual void updateImpactPrec() = 0;
 	virtual void updateRecords() = 0;
-	virtual void doPosteriorDraws() = 0;
-	virtual Rcpp::List returnRecords(int num_burn, int thin) const = 0;
+	// Updates before h_t, which differ by prior
+	virtual void updateBeforeState() = 0;
+	void updateAfterState() {
+		updateStateVar();
+		stage_timer.lap(STATE_VAR);
+		updateInitState();
+		stage_timer.lap(INIT_STATE);
+		updateRecords();
+		stage_timer.lap(RECORDS);
+	}
+	virtual void doPosteriorDraws() {
+		std::lock_guard<std::mutex> lock(mtx);
+		updateBeforeState();
+		updateState();
+		stage_timer.lap(STATE);
+		updateAfterState();
+	}
+	// Lockstep chains
+	//
+	// Chains sharing a thread run each sweep together, and h_t of each variable is drawn for every chain in one varsv_ht_lockstep() call.
+	// The kernel time is split evenly over the chains.
+	static void doLockstepDraws(const std::vector<McmcSv*>& chains) {
+		std::vector<std::unique_lock<std::mutex>> locks;
+		for (McmcSv* chain : chains) {
+			locks.emplace_back(chain->mtx);
+			chain->updateBeforeState();
+			chain->updateStateResid();
+			chain->stage_timer.lap(STATE);
+		}
+		int num_chains = chains.size();
+		int num_lvol = chains[0]->num_lvol;
+		int num_design = chains[0]->num_design;
+		Eigen::MatrixXd lvol_lockstep(num_design, num_chains);
+		Eigen::MatrixXd latent_lockstep(num_design, num_chains);
+		Eigen::VectorXd init_lockstep(num_chains);
+		Eigen::VectorXd sig_lockstep(num_chains);
+		std::vector<boost::random::mt19937*> rng_lockstep(num_chains);
+		for (McmcSv* chain : chains) {
+			chain->stage_timer.start();
+		}
+		for (int t = 0; t < num_lvol; t++) {
+			for (int i = 0; i < num_chains; i++) {
+				lvol_lockstep.col(i) = chains[i]->lvol_draw.col(t);
+				latent_lockstep.col(i) = chains[i]->ortho_latent.col(t);
+				init_lockstep[i] = chains[i]->lvol_init[t];
+				sig_lockstep[i] = chains[i]->lvol_sig[t];
+				rng_lockstep[i] = &chains[i]->task_rng[t];
+			}
+			varsv_ht_lockstep(lvol_lockstep, init_lockstep, sig_lockstep, latent_lockstep, rng_lockstep);
+			for (int i = 0; i < num_chains; i++) {
+				chains[i]->lvol_draw.col(t) = lvol_lockstep.col(i);
+			}
+		}
+		for (McmcSv* chain : chains) {
+			chain->stage_timer.share(STATE, num_chains);
+			chain->updateAfterState();
+		}
+	}
+	virtual Rcpp::List returnRecords() const = 0;
+	Eigen::MatrixXd returnCoefTrace(const Eigen::VectorXi& param_id) const {
+		return sv_record.returnCoefTrace(mcmc_step, param_id);
+	}
+	// Checkpoint: parameters carried over to the next iteration, RNG, and records written so far
+	virtual void saveState(std::ostream& os) const {
+		int step = mcmc_step;
+		write_state(os, step);
+		write_state(os, rng);
+		for (const auto& task : task_rng) {
+			write_state(os, task);
+		}
+		write_state(os, coef_vec);
+		write_state(os, coef_mat);
+		write_state(os, latent_innov); // recomputing Y0 - X0 A in one product is not bitwise the column-wise update
+		write_state(os, contem_coef);
+		write_state(os, chol_lower);
+		write_state(os, struct_coef);
+		write_state(os, lvol_draw);
+		write_state(os, lvol_init);
+		write_state(os, lvol_sig);
+		write_state(os, factor_draw);
+		sv_record.saveRecords(os, step);
+	}
+	virtual void loadState(std::istream& is) {
+		int step;
+		read_state(is, step);
+		mcmc_step = step;
+		read_state(is, rng);
+		for (auto& task : task_rng) {
+			read_state(is, task);
+		}
+		read_state(is, coef_vec);
+		read_state(is, coef_mat);
+		read_state(is, latent_innov);
+		read_state(is, contem_coef);
+		read_state(is, chol_lower);
+		read_state(is, struct_coef);
+		updateStructVec();
+		read_state(is, lvol_draw);
+		read_state(is, lvol_init);
+		read_state(is, lvol_sig);
+		read_state(is, factor_draw);
+		loading_mat = build_factor_loading(dim, num_factor, contem_coef);
+		sv_record.loadRecords(is, step);
+	}
 
 protected:
+	// Coefficients under the coefficient prior: A, or Gamma in structural form
+	const Eigen::VectorXd& priorCoef() const {
+		return is_structural ? struct_vec : coef_vec;
+	}
+	void updateStructVec() {
+		struct_vec.head(num_alpha) = struct_coef.topRows(num_alpha / dim).reshaped();
+		if (include_mean) {
+			struct_vec.tail(dim) = struct_coef.bottomRows(1).transpose();
+		}
+	}
 	bool include_mean;
-	Eigen::MatrixXd x;
-	Eigen::MatrixXd y;
+	Eigen::Ref<const Eigen::MatrixXd> x; // shared by chains
+	Eigen::Ref<const Eigen::MatrixXd> y;
 	std::mutex mtx;
 	int num_iter;
+	int num_burn;
+	int thin;
 	int dim; // k
   int dim_design; // kp(+1)
   int num_design; // n = T - p
-  int num_lowerchol;
+	int num_factor; // q
+  int num_lowerchol; // a in Cholesky structure, or free loadings in factor structure
   int num_coef;
 	int num_alpha;
+	int num_lvol; // k + q log-volatilities
 	SvRecords sv_record;
 	std::atomic<int> mcmc_step; // MCMC step
 	boost::random::mt19937 rng; // RNG instance for multi-chain
+	int nthreads_intra; // threads within the chain
+	enum Stage { COEF_PREC, COEF, COEF_SHRINK, IMPACT_PREC, IMPACT, STATE, STATE_VAR, INIT_STATE, RECORDS, NUM_STAGE };
+	StageTimer stage_timer;
+	std::vector<boost::random::mt19937> task_rng; // RNG substream of each variable for intra-chain parallelism
 	Eigen::VectorXd prior_mean_non; // prior mean of intercept term
 	Eigen::VectorXd prior_sd_non; // prior sd of intercept term: c^2 I
 	Eigen::VectorXd coef_vec;
@@ -362,14 +760,16 @@ protected:
 	Eigen::VectorXd prior_chol_mean; // prior mean vector of a = 0
 	Eigen::MatrixXd prior_chol_prec; // prior precision of a = I
 	Eigen::MatrixXd coef_mat;
-	int contem_id;
 	Eigen::MatrixXd chol_lower; // L in Sig_t^(-1) = L D_t^(-1) LT
+	Eigen::MatrixXd factor_draw; // f_t = (f_1t, ..., f_qt), t = 1, ..., n => n x q
+	Eigen::MatrixXd loading_mat; // Lambda in Sig_t = Lambda V_t Lambda^T + D_t
+	bool is_structural;
+	Eigen::MatrixXd struct_coef; // Gamma = A L^T of structural form
+	Eigen::VectorXd struct_vec; // Gamma vectorized as coef_vec
 	Eigen::MatrixXd latent_innov; // Z0 = Y0 - X0 A = (eps_p+1, eps_p+2, ..., eps_n+p)^T
   Eigen::MatrixXd ortho_latent; // orthogonalized Z0
 	Eigen::VectorXd prior_mean_j; // Prior mean vector of j-th column of A
   Eigen::MatrixXd prior_prec_j; // Prior precision of j-th column of A
-  Eigen::MatrixXd coef_j; // j-th column of A = 0: A(-j) = (alpha_1, ..., alpha_(j-1), 0, alpha_(j), ..., alpha_k)
-	Eigen::VectorXd response_contem; // j-th column of Z0 = Y0 - X0 * A: n-dim
 	Eigen::MatrixXd sqrt_sv; // stack sqrt of exp(h_t) = (exp(-h_1t / 2), ..., exp(-h_kt / 2)), t = 1, ..., n => n x k
 
 private:
@@ -395,34 +795,14 @@ public:
 	void updateCoefShrink() override {};
 	void updateImpactPrec() override {};
 	void updateRecords() override { sv_record.assignRecords(mcmc_step, coef_vec, contem_coef, lvol_draw, lvol_sig, lvol_init); }
-	void doPosteriorDraws() override {
-		std::lock_guard<std::mutex> lock(mtx);
+	void updateBeforeState() override {
 		addStep();
+		stage_timer.start();
 		sqrt_sv = (-lvol_draw / 2).array().exp(); // D_t before coef
-		updateCoef();
-		latent_innov = y - x * coef_mat; // E_t before a
-		updateImpact();
-		chol_lower = build_inv_lower(dim, contem_coef); // L before h_t
-		updateState();
-		updateStateVar();
-		updateInitState();
-		updateRecords();
+		updateCoefImpact();
 	}
-	Rcpp::List returnRecords(int num_burn, int thin) const override {
-		Rcpp::List res = Rcpp::List::create(
-			Rcpp::Named("alpha_record") = sv_record.coef_record.leftCols(num_alpha),
-			Rcpp::Named("h_record") = sv_record.lvol_record,
-			Rcpp::Named("a_record") = sv_record.contem_coef_record,
-			Rcpp::Named("h0_record") = sv_record.lvol_init_record,
-			Rcpp::Named("sigh_record") = sv_record.lvol_sig_record
-		);
-		if (include_mean) {
-			res["c_record"] = sv_record.coef_record.rightCols(dim);
-		}
-		for (auto& record : res) {
-			record = thin_record(Rcpp::as<Eigen::MatrixXd>(record), num_iter, num_burn, thin);
-		}
-		return res;
+	Rcpp::List returnRecords() const override {
+		return sv_record.returnRecords(mcmc_step, include_mean);
 	}
 };
 
@@ -431,7 +811,7 @@ public:
 	SsvsSv(const SsvsParams& params, const SsvsInits& inits, unsigned int seed)
 	: McmcSv(params, inits, seed),
 		grp_id(params._grp_id), grp_mat(params._grp_mat), grp_vec(grp_mat.reshaped()), num_grp(grp_id.size()),
-		ssvs_record(num_iter, num_alpha, num_grp, num_lowerchol),
+		ssvs_record(num_iter, num_burn, thin, params._summary, num_alpha, num_grp, num_lowerchol),
 		coef_dummy(inits._coef_dummy), coef_weight(inits._coef_weight),
 		contem_dummy(Eigen::VectorXd::Ones(num_lowerchol)), contem_weight(inits._contem_weight),
 		coef_spike(params._coef_spike), coef_slab(params._coef_slab),
@@ -464,7 +844,7 @@ public:
 		slab_weight = slab_weight_mat.reshaped();
 		ssvs_dummy(
 			coef_dummy,
-			coef_vec.head(num_alpha),
+			priorCoef().head(num_alpha),
 			coef_slab, coef_spike, slab_weight,
 			rng
 		);
@@ -479,39 +859,37 @@ public:
 		sv_record.assignRecords(mcmc_step, coef_vec, contem_coef, lvol_draw, lvol_sig, lvol_init);
 		ssvs_record.assignRecords(mcmc_step, coef_dummy, coef_weight, contem_dummy, contem_weight);
 	}
-	void doPosteriorDraws() override {
-		std::lock_guard<std::mutex> lock(mtx);
+	void updateBeforeState() override {
 		addStep();
+		stage_timer.start();
 		updateCoefPrec();
+		stage_timer.lap(COEF_PREC);
 		sqrt_sv = (-lvol_draw / 2).array().exp(); // D_t before coef
-		updateCoef();
-		updateCoefShrink();
-		updateImpactPrec();
-		latent_innov = y - x * coef_mat; // E_t before a
-		updateImpact();
-		chol_lower = build_inv_lower(dim, contem_coef); // L before h_t
-		updateState();
-		updateStateVar();
-		updateInitState();
-		updateRecords();
+		updateCoefImpact();
 	}
-	Rcpp::List returnRecords(int num_burn, int thin) const override {
-		Rcpp::List res = Rcpp::List::create(
-			Rcpp::Named("alpha_record") = sv_record.coef_record.leftCols(num_alpha),
-			Rcpp::Named("h_record") = sv_record.lvol_record,
-			Rcpp::Named("a_record") = sv_record.contem_coef_record,
-			Rcpp::Named("h0_record") = sv_record.lvol_init_record,
-			Rcpp::Named("sigh_record") = sv_record.lvol_sig_record,
-			Rcpp::Named("gamma_record") = ssvs_record.coef_dummy_record
-		);
-		if (include_mean) {
-			res["c_record"] = sv_record.coef_record.rightCols(dim);
-		}
-		for (auto& record : res) {
-			record = thin_record(Rcpp::as<Eigen::MatrixXd>(record), num_iter, num_burn, thin);
-		}
+	Rcpp::List returnRecords() const override {
+		Rcpp::List res = sv_record.returnRecords(mcmc_step, include_mean);
+		res["gamma_record"] = ssvs_record.coef_dummy_record.returnRecord(mcmc_step);
 		return res;
 	}
+	void saveState(std::ostream& os) const override {
+		McmcSv::saveState(os);
+		write_state(os, coef_dummy);
+		write_state(os, coef_weight);
+		write_state(os, contem_dummy);
+		write_state(os, contem_weight);
+		write_state(os, slab_weight_mat);
+		ssvs_record.saveRecords(os, mcmc_step);
+	}
+	void loadState(std::istream& is) override {
+		McmcSv::loadState(is);
+		read_state(is, coef_dummy);
+		read_state(is, coef_weight);
+		read_state(is, contem_dummy);
+		read_state(is, contem_weight);
+		read_state(is, slab_weight_mat);
+		ssvs_record.loadRecords(is, mcmc_step);
+	}
 private:
 	Eigen::VectorXi grp_id;
 	Eigen::MatrixXi grp_mat;
@@ -539,7 +917,7 @@ public:
 	HorseshoeSv(const HorseshoeParams& params, const HorseshoeInits& inits, unsigned int seed)
 	: McmcSv(params, inits, seed),
 		grp_id(params._grp_id), grp_mat(params._grp_mat), grp_vec(grp_mat.reshaped()), num_grp(grp_id.size()),
-		hs_record(num_iter, num_alpha, num_grp, num_lowerchol),
+		hs_record(num_iter, num_burn, thin, params._summary, num_alpha, num_grp),
 		local_lev(inits._init_local), global_lev(inits._init_global),
 		shrink_fac(Eigen::VectorXd::Zero(num_alpha)),
 		latent_local(Eigen::VectorXd::Zero(num_alpha)), latent_global(Eigen::VectorXd::Zero(num_grp)),
@@ -568,8 +946,8 @@ public:
 	void updateCoefShrink() override {
 		horseshoe_latent(latent_local, local_lev, rng);
 		horseshoe_latent(latent_global, global_lev, rng);
-		horseshoe_local_sparsity(local_lev, latent_local, coef_var, coef_vec.head(num_alpha), 1, rng);
-		horseshoe_mn_global_sparsity(global_lev, grp_vec, grp_id, latent_global, local_lev, coef_vec.head(num_alpha), 1, rng);
+		horseshoe_local_sparsity(local_lev, latent_local, coef_var, priorCoef().head(num_alpha), 1, rng);
+		horseshoe_mn_global_sparsity(global_lev, grp_vec, grp_id, latent_global, local_lev, priorCoef().head(num_alpha), 1, rng);
 	}
 	void updateImpactPrec() override {
 		horseshoe_latent(latent_contem_local, contem_local_lev, rng);
@@ -584,41 +962,39 @@ public:
 		sv_record.assignRecords(mcmc_step, coef_vec, contem_coef, lvol_draw, lvol_sig, lvol_init);
 		hs_record.assignRecords(mcmc_step, shrink_fac, local_lev, global_lev);
 	}
-	void doPosteriorDraws() override {
-		std::lock_guard<std::mutex> lock(mtx);
+	void updateBeforeState() override {
 		addStep();
+		stage_timer.start();
 		updateCoefPrec();
+		stage_timer.lap(COEF_PREC);
 		sqrt_sv = (-lvol_draw / 2).array().exp(); // D_t before coef
-		updateCoef();
-		updateCoefShrink();
-		updateImpactPrec();
-		latent_innov = y - x * coef_mat; // E_t before a
-		updateImpact();
-		chol_lower = build_inv_lower(dim, contem_coef); // L before h_t
-		updateState();
-		updateStateVar();
-		updateInitState();
-		updateRecords();
+		updateCoefImpact();
 	}
-	Rcpp::List returnRecords(int num_burn, int thin) const override {
-		Rcpp::List res = Rcpp::List::create(
-			Rcpp::Named("alpha_record") = sv_record.coef_record.leftCols(num_alpha),
-			Rcpp::Named("h_record") = sv_record.lvol_record,
-			Rcpp::Named("a_record") = sv_record.contem_coef_record,
-			Rcpp::Named("h0_record") = sv_record.lvol_init_record,
-			Rcpp::Named("sigh_record") = sv_record.lvol_sig_record,
-			Rcpp::Named("lambda_record") = hs_record.local_record,
-			Rcpp::Named("tau_record") = hs_record.global_record,
-			Rcpp::Named("kappa_record") = hs_record.shrink_record
-		);
-		if (include_mean) {
-			res["c_record"] = sv_record.coef_record.rightCols(dim);
-		}
-		for (auto& record : res) {
-			record = thin_record(Rcpp::as<Eigen::MatrixXd>(record), num_iter, num_burn, thin);
-		}
+	Rcpp::List returnRecords() const override {
+		Rcpp::List res = sv_record.returnRecords(mcmc_step, include_mean);
+		res["lambda_record"] = hs_record.local_record.returnRecord(mcmc_step);
+		res["tau_record"] = hs_record.global_record.returnRecord(mcmc_step);
+		res["kappa_record"] = hs_record.shrink_record.returnRecord(mcmc_step);
 		return res;
 	}
+	void saveState(std::ostream& os) const override {
+		McmcSv::saveState(os);
+		write_state(os, local_lev);
+		write_state(os, global_lev);
+		write_state(os, coef_var_loc);
+		write_state(os, contem_local_lev);
+		write_state(os, contem_global_lev);
+		hs_record.saveRecords(os, mcmc_step);
+	}
+	void loadState(std::istream& is) override {
+		McmcSv::loadState(is);
+		read_state(is, local_lev);
+		read_state(is, global_lev);
+		read_state(is, coef_var_loc);
+		read_state(is, contem_local_lev);
+		read_state(is, contem_global_lev);
+		hs_record.loadRecords(is, mcmc_step);
+	}
 
 private:
 	Eigen::VectorXi grp_id;
@@ -641,6 +1017,11 @@ private:
 	Eigen::VectorXd latent_contem_global;
 };
 
+// Lockstep draws of SV chains sharing one thread
+inline void draw_lockstep(const std::vector<McmcSv*>& chains) {
+	McmcSv::doLockstepDraws(chains);
+}
+
 } // namespace bvhar
 
 #endif // MCMCSV_H
\ No newline at end of file
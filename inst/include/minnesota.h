@@ -7,6 +7,17 @@
 
 namespace bvhar {
 
+struct MinnFit {
+	Eigen::MatrixXd _coef;
+	int _ord; // p of BVAR(p), or month of BVHAR as VAR(month)
+	Eigen::MatrixXd _prec;
+	Eigen::MatrixXd _iw_scale;
+	double _iw_shape;
+
+	MinnFit(const Eigen::MatrixXd& coef_mat, int ord, const Eigen::MatrixXd& prec_mat, const Eigen::MatrixXd& iw_scale, double iw_shape)
+	: _coef(coef_mat), _ord(ord), _prec(prec_mat), _iw_scale(iw_scale), _iw_shape(iw_shape) {}
+};
+
 struct MinnSpec {
 	Eigen::VectorXd _sigma;
 	double _lambda;
@@ -96,6 +107,12 @@ public:
 			Rcpp::Named("design") = design
 		);
 	}
+	MinnFit returnMinnFit(int ord) {
+		estimateCoef();
+		fitObs();
+		estimateCov();
+		return MinnFit(coef, ord, prec, scale, prior_shape + num_design);
+	}
 private:
 	Eigen::MatrixXd design;
 	Eigen::MatrixXd response;
@@ -147,6 +164,9 @@ public:
 		mn_res["y"] = data;
 		return mn_res;
 	}
+	MinnFit returnMinnFit() {
+		return _mn->returnMinnFit(lag);
+	}
 private:
 	int lag;
 	bool const_term;
@@ -166,8 +186,7 @@ public:
 		data(y), dim(data.cols()) {
 		response = build_y0(data, month, month + 1);
 		har_trans = bvhar::build_vhar(dim, week, month, const_term);
-		var_design = build_x0(data, month, const_term);
-		design = var_design * har_trans.transpose();
+		design = build_har_x0(data, week, month, const_term);
 		dummy_design = build_xdummy(
 			Eigen::VectorXd::LinSpaced(3, 1, 3),
 			spec._lambda, spec._sigma, spec._eps, const_term
@@ -175,17 +194,22 @@ public:
 	}
 	virtual ~MinnBvhar() = default;
 	virtual Rcpp::List returnMinnRes() = 0;
+	MinnFit returnMinnFit() {
+		MinnFit mn_fit = _mn->returnMinnFit(month);
+		mn_fit._coef = har_trans.transpose() * mn_fit._coef; // VAR(month) coefficient
+		return mn_fit;
+	}
 protected:
 	int week;
 	int month;
 	bool const_term;
 	Eigen::MatrixXd data;
 	int dim;
-	Eigen::MatrixXd var_design;
 	Eigen::MatrixXd response;
 	Eigen::MatrixXd har_trans;
 	Eigen::MatrixXd design;
 	Eigen::MatrixXd dummy_design;
+	std::unique_ptr<Minnesota> _mn;
 };
 
 class MinnBvharS : public MinnBvhar {
@@ -212,7 +236,6 @@ public:
 		return mn_res;
 	}
 private:
-	std::unique_ptr<Minnesota> _mn;
 	Eigen::MatrixXd dummy_response;
 };
 
@@ -240,7 +263,6 @@ public:
 		return mn_res;
 	}
 private:
-	std::unique_ptr<Minnesota> _mn;
 	Eigen::MatrixXd dummy_response;
 };
 
@@ -6,6 +6,15 @@
 
 namespace bvhar {
 
+struct OlsFit {
+	Eigen::MatrixXd _coef;
+	int _ord; // p of VAR(p), or month of VHAR as VAR(month)
+	Eigen::MatrixXd _cov;
+
+	OlsFit(const Eigen::MatrixXd& coef_mat, int ord, const Eigen::MatrixXd& cov_mat)
+	: _coef(coef_mat), _ord(ord), _cov(cov_mat) {}
+};
+
 class MultiOls {
 public:
 	MultiOls(const Eigen::MatrixXd& x, const Eigen::MatrixXd& y)
@@ -42,6 +51,12 @@ public:
 			Rcpp::Named("y0") = response
 		);
 	}
+	OlsFit returnOlsFit(int ord) {
+		estimateCoef();
+		fitObs();
+		estimateCov();
+		return OlsFit(coef, ord, cov);
+	}
 protected:
 	Eigen::MatrixXd design;
 	Eigen::MatrixXd response;
@@ -109,6 +124,9 @@ public:
 		ols_res["y"] = data;
 		return ols_res;
 	}
+	OlsFit returnOlsFit() {
+		return _ols->returnOlsFit(lag);
+	}
 protected:
 	int lag;
 	bool const_term;
@@ -124,8 +142,7 @@ public:
 	: week(week), month(month), const_term(include_mean), data(y) {
 		response = build_y0(data, month, month + 1);
 		har_trans = bvhar::build_vhar(response.cols(), week, month, const_term);
-		var_design = build_x0(data, month, const_term);
-		design = var_design * har_trans.transpose();
+		design = build_har_x0(data, week, month, const_term);
 		switch (method) {
 		case 1:
 			_ols = std::unique_ptr<MultiOls>(new MultiOls(design, response));
@@ -148,10 +165,15 @@ public:
 		ols_res["process"] = "VHAR";
 		ols_res["type"] = const_term ? "const" : "none";
 		ols_res["HARtrans"] = har_trans;
-		ols_res["design"] = var_design;
+		ols_res["design"] = build_x0(data, month, const_term);
 		ols_res["y"] = data;
 		return ols_res;
 	}
+	OlsFit returnOlsFit() {
+		OlsFit ols_fit = _ols->returnOlsFit(month);
+		ols_fit._coef = har_trans.transpose() * ols_fit._coef; // VAR(month) coefficient
+		return ols_fit;
+	}
 protected:
 	int week;
 	int month;
@@ -159,11 +181,84 @@ protected:
 	Eigen::MatrixXd data;
 	std::unique_ptr<MultiOls> _ols;
 	Eigen::MatrixXd response;
-	Eigen::MatrixXd var_design;
 	Eigen::MatrixXd design;
 	Eigen::MatrixXd har_trans;
 };
 
+class OlsCriteria {
+public:
+	OlsCriteria(const Eigen::MatrixXd& y, int lag_max, const bool include_mean)
+	: lag_max(lag_max), const_term(include_mean) {
+		response = build_y0(y, lag_max, lag_max + 1); // common sample for every candidate
+		design = build_x0(y, lag_max, const_term);
+		dim = response.cols();
+		num_design = response.rows();
+	}
+	virtual ~OlsCriteria() = default;
+	Eigen::MatrixXd computeVarCriteria() {
+		// [1, Y1, ..., Yp]: each VAR(p) uses the leading columns of the largest design
+		int dim_design = design.cols();
+		Eigen::MatrixXd nested_design(num_design, dim_design);
+		if (const_term) {
+			nested_design.col(0) = design.col(dim_design - 1);
+		}
+		nested_design.rightCols(dim * lag_max) = design.leftCols(dim * lag_max);
+		Eigen::HouseholderQR<Eigen::MatrixXd> qr_design(nested_design);
+		Eigen::MatrixXd qty = qr_design.householderQ().transpose() * response; // rows after the leading k ones are orthogonal to VAR(p) columns
+		Eigen::MatrixXd ic_res(lag_max, 4);
+		Eigen::MatrixXd sse_mat = qty.bottomRows(num_design - dim_design).transpose() * qty.bottomRows(num_design - dim_design);
+		for (int i = lag_max; i > 0; i--) {
+			ic_res.row(i - 1) = computeCriteria(sse_mat, dim * i + (const_term ? 1 : 0));
+			// SSE of VAR(p - 1) = SSE of VAR(p) + contribution of the lag-p block
+			sse_mat += qty.middleRows(dim * (i - 1) + (const_term ? 1 : 0), dim).transpose() * qty.middleRows(dim * (i - 1) + (const_term ? 1 : 0), dim);
+		}
+		return ic_res;
+	}
+	Eigen::MatrixXd computeVharCriteria(const Eigen::VectorXi& week, const Eigen::VectorXi& month, int nthreads) {
+		// VHAR design = X0 * HARtrans^T, so every candidate shares X0^T X0, X0^T Y0, and Y0^T Y0
+		int num_grid = week.size();
+		Eigen::MatrixXd gram = design.transpose() * design;
+		Eigen::MatrixXd xy = design.transpose() * response;
+		Eigen::MatrixXd yy = response.transpose() * response;
+		Eigen::MatrixXd ic_res(num_grid, 4);
+	#ifdef _OPENMP
+		#pragma omp parallel for num_threads(nthreads)
+	#endif
+		for (int i = 0; i < num_grid; i++) {
+			Eigen::MatrixXd har_trans = build_vhar(dim, week[i], month[i], const_term);
+			Eigen::MatrixXd har_full = Eigen::MatrixXd::Zero(har_trans.rows(), design.cols()); // pad to lag_max
+			har_full.leftCols(dim * month[i]) = har_trans.leftCols(dim * month[i]);
+			if (const_term) {
+				har_full.rightCols(1) = har_trans.rightCols(1);
+			}
+			Eigen::LLT<Eigen::MatrixXd> llt_har(har_full * gram * har_full.transpose());
+			Eigen::MatrixXd har_xy = har_full * xy;
+			Eigen::MatrixXd sse_mat = yy - har_xy.transpose() * llt_har.solve(har_xy);
+			ic_res.row(i) = computeCriteria(sse_mat, har_trans.rows());
+		}
+		return ic_res;
+	}
+protected:
+	int lag_max;
+	bool const_term;
+	int dim; // k
+	int num_design; // n - lag_max
+	Eigen::MatrixXd response;
+	Eigen::MatrixXd design;
+	Eigen::RowVector4d computeCriteria(const Eigen::MatrixXd& sse_mat, int dim_design) {
+		// AIC-BIC-HQ-FPE as in compute_aic(), compute_bic(), compute_hq(), and compute_fpe()
+		Eigen::RowVector4d ic_res;
+		double obs = num_design;
+		double num_coef = dim * dim_design;
+		double log_det = log((sse_mat / obs).determinant()); // log det(crossprod(resid) / s)
+		ic_res[0] = log_det + 2 / obs * num_coef;
+		ic_res[1] = log_det + log(obs) / obs * num_coef;
+		ic_res[2] = log_det + 2 * log(log(obs)) / obs * num_coef;
+		ic_res[3] = pow((obs + dim_design) / obs, dim) * (sse_mat / (obs - dim_design)).determinant();
+		return ic_res;
+	}
+};
+
 } // namespace bvhar
 
 #endif // OLS_H
\ No newline at end of file
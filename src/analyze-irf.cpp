@@ -0,0 +1,77 @@
+#include "bvharstructural.h"
+
+//' Impulse Responses and FEVD of Posterior Draws in VAR
+//' 
+//' This function computes posterior mean and quantiles of impulse responses and forecast error variance decomposition.
+//' 
+//' @param alpha_record MCMC record of VAR coefficients without constant term
+//' @param var_lag VAR lag
+//' @param cov_record MCMC record of covariance matrix parameters.
+//' `cbind(a_record, h_record)` at one time point when `cov_type = 1`, `chol_record` when `cov_type = 2`, and `sigma_record` when `cov_type = 3`.
+//' @param cov_type Covariance parameterization. 1: SV, 2: SSVS, 3: Horseshoe.
+//' @param lag_max Maximum lag for VMA
+//' @param probs Probabilities for quantiles
+//' @param orthogonal Orthogonalized impulse responses using Cholesky factor
+//' @param nthreads Number of threads for openmp
+//' 
+//' @details
+//' The VMA recursion runs one horizon at a time for every draw,
+//' so that only the last p VMA coefficients of each draw are kept in memory.
+//' Each matrix has the same layout as `VARcoeftoVMA_ortho()`: rows are impulses and columns are responses.
+//' FEVD of each column (response) sums to one.
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List compute_var_irf_draws(Eigen::MatrixXd alpha_record, int var_lag, Eigen::MatrixXd cov_record, int cov_type,
+																 int lag_max, Eigen::VectorXd probs, bool orthogonal, int nthreads) {
+	if (lag_max < 1) {
+		Rcpp::stop("'lag_max' must larger than 0");
+	}
+	if (alpha_record.rows() != cov_record.rows()) {
+		Rcpp::stop("'alpha_record' and 'cov_record' should have the same number of draws.");
+	}
+	if (cov_type < 1 || cov_type > 3) {
+		Rcpp::stop("'cov_type' should be 1 (SV), 2 (SSVS), or 3 (Horseshoe).");
+	}
+	bvhar::McmcIrf irf_draws(alpha_record, cov_record, cov_type, var_lag, lag_max);
+	irf_draws.computeQuantile(probs, orthogonal, nthreads);
+	return irf_draws.returnIrf();
+}
+
+//' Impulse Responses and FEVD of Posterior Draws in VHAR
+//' 
+//' This function computes posterior mean and quantiles of impulse responses and forecast error variance decomposition.
+//' 
+//' @param phi_record MCMC record of VHAR coefficients without constant term
+//' @param HARtrans VHAR linear transformation matrix without constant term
+//' @param cov_record MCMC record of covariance matrix parameters.
+//' @param cov_type Covariance parameterization. 1: SV, 2: SSVS, 3: Horseshoe.
+//' @param lag_max Maximum lag for VMA
+//' @param probs Probabilities for quantiles
+//' @param orthogonal Orthogonalized impulse responses using Cholesky factor
+//' @param nthreads Number of threads for openmp
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List compute_vhar_irf_draws(Eigen::MatrixXd phi_record, Eigen::MatrixXd HARtrans, Eigen::MatrixXd cov_record, int cov_type,
+																	int lag_max, Eigen::VectorXd probs, bool orthogonal, int nthreads) {
+	if (lag_max < 1) {
+		Rcpp::stop("'lag_max' must larger than 0");
+	}
+	if (phi_record.rows() != cov_record.rows()) {
+		Rcpp::stop("'phi_record' and 'cov_record' should have the same number of draws.");
+	}
+	if (cov_type < 1 || cov_type > 3) {
+		Rcpp::stop("'cov_type' should be 1 (SV), 2 (SSVS), or 3 (Horseshoe).");
+	}
+	int num_draws = phi_record.rows();
+	int dim = HARtrans.rows() / 3;
+	int month = HARtrans.cols() / dim;
+	Eigen::MatrixXd alpha_record(num_draws, dim * dim * month);
+	for (int i = 0; i < num_draws; i++) {
+		alpha_record.row(i) = (HARtrans.transpose() * phi_record.row(i).reshaped(3 * dim, dim)).reshaped().transpose(); // bhat = tilde(T)^T * Phi
+	}
+	bvhar::McmcIrf irf_draws(alpha_record, cov_record, cov_type, month, lag_max);
+	irf_draws.computeQuantile(probs, orthogonal, nthreads);
+	return irf_draws.returnIrf();
+}
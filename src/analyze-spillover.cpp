@@ -0,0 +1,111 @@
+#include "bvharspillover.h"
+
+//' Rolling-window Spillover of VAR
+//' 
+//' This function computes generalized FEVD-based spillover table of VAR in each rolling window.
+//' 
+//' @param y Time series data of which columns indicate the variables
+//' @param window Window size
+//' @param step Forecast horizon of FEVD
+//' @param lag VAR lag
+//' @param include_mean Add constant term
+//' @param method Method to solve linear equation system. 1: normal equation, 2: cholesky, 3: HouseholderQR.
+//' @param nthreads Number of threads for openmp
+//' 
+//' @details
+//' Each row of `connect` is the vectorized (column-major) spillover table of a window in percent,
+//' whose (i, j) element is the share of variable i's forecast error variance due to shock j.
+//' `to`, `from`, `net`, and `tot` are directional and total spillover indices of Diebold and Yilmaz (2012).
+//' 
+//' @references Diebold, F. X., & Yilmaz, K. (2012). *Better to give than to receive: Predictive directional measurement of volatility spillovers*. International Journal of forecasting, 28(1), 57-66.
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List dynamic_var_spillover(Eigen::MatrixXd y, int window, int step, int lag, bool include_mean, int method, int nthreads) {
+	auto fit = [&](const Eigen::MatrixXd& y_window) {
+		bvhar::OlsVar ols_obj(y_window, lag, include_mean, method);
+		return ols_obj.returnOlsFit();
+	};
+	return bvhar::compute_dynamic_spillover(y, window, step, lag, fit, nthreads);
+}
+
+//' Rolling-window Spillover of VHAR
+//' 
+//' This function computes generalized FEVD-based spillover table of VHAR in each rolling window.
+//' 
+//' @param y Time series data of which columns indicate the variables
+//' @param window Window size
+//' @param step Forecast horizon of FEVD
+//' @param week Order for weekly term
+//' @param month Order for monthly term
+//' @param include_mean Add constant term
+//' @param method Method to solve linear equation system. 1: normal equation, 2: cholesky, 3: HouseholderQR.
+//' @param nthreads Number of threads for openmp
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List dynamic_vhar_spillover(Eigen::MatrixXd y, int window, int step, int week, int month, bool include_mean, int method, int nthreads) {
+	auto fit = [&](const Eigen::MatrixXd& y_window) {
+		bvhar::OlsVhar ols_obj(y_window, week, month, include_mean, method);
+		return ols_obj.returnOlsFit();
+	};
+	return bvhar::compute_dynamic_spillover(y, window, step, month, fit, nthreads);
+}
+
+//' Rolling-window Spillover of BVAR
+//' 
+//' This function computes generalized FEVD-based spillover table of Minnesota BVAR in each rolling window.
+//' Covariance matrix is the posterior mean of inverse-Wishart distribution.
+//' 
+//' @param y Time series data of which columns indicate the variables
+//' @param window Window size
+//' @param step Forecast horizon of FEVD
+//' @param lag BVAR lag
+//' @param bayes_spec BVAR Minnesota specification
+//' @param include_mean Add constant term
+//' @param nthreads Number of threads for openmp
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List dynamic_bvar_spillover(Eigen::MatrixXd y, int window, int step, int lag, Rcpp::List bayes_spec, bool include_mean, int nthreads) {
+	bvhar::BvarSpec mn_spec(bayes_spec);
+	auto fit = [&](const Eigen::MatrixXd& y_window) {
+		bvhar::MinnBvar mn_obj(y_window, lag, mn_spec, include_mean);
+		return mn_obj.returnMinnFit();
+	};
+	return bvhar::compute_dynamic_spillover(y, window, step, lag, fit, nthreads);
+}
+
+//' Rolling-window Spillover of BVHAR
+//' 
+//' This function computes generalized FEVD-based spillover table of Minnesota BVHAR in each rolling window.
+//' Covariance matrix is the posterior mean of inverse-Wishart distribution.
+//' 
+//' @param y Time series data of which columns indicate the variables
+//' @param window Window size
+//' @param step Forecast horizon of FEVD
+//' @param week Order for weekly term
+//' @param month Order for monthly term
+//' @param bayes_spec BVHAR Minnesota specification
+//' @param include_mean Add constant term
+//' @param minn_short VAR-type Minnesota prior (`TRUE`) or VHAR-type (`FALSE`)
+//' @param nthreads Number of threads for openmp
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List dynamic_bvhar_spillover(Eigen::MatrixXd y, int window, int step, int week, int month, Rcpp::List bayes_spec,
+																	 bool include_mean, bool minn_short, int nthreads) {
+	if (minn_short) {
+		bvhar::BvarSpec mn_spec(bayes_spec);
+		auto fit = [&](const Eigen::MatrixXd& y_window) {
+			bvhar::MinnBvharS mn_obj(y_window, week, month, mn_spec, include_mean);
+			return mn_obj.returnMinnFit();
+		};
+		return bvhar::compute_dynamic_spillover(y, window, step, month, fit, nthreads);
+	}
+	bvhar::BvharSpec mn_spec(bayes_spec);
+	auto fit = [&](const Eigen::MatrixXd& y_window) {
+		bvhar::MinnBvharL mn_obj(y_window, week, month, mn_spec, include_mean);
+		return mn_obj.returnMinnFit();
+	};
+	return bvhar::compute_dynamic_spillover(y, window, step, month, fit, nthreads);
+}
@@ -45,6 +45,31 @@ Eigen::MatrixXd build_design(Eigen::MatrixXd y, int var_lag, bool include_mean)
 	return bvhar::build_x0(y, var_lag, include_mean);
 }
 
+//' Build Design Matrix of VHAR
+//' 
+//' This function constructs design matrix of VHAR directly from rolling means.
+//' 
+//' @param y Matrix, time series data
+//' @param har Integer vector, increasing orders of each HAR term, e.g. `c(1, 5, 22)`
+//' @param include_mean bool, Add constant term (Default: `true`) or not (`false`)
+//' 
+//' @details
+//' Same as \eqn{X_1 = X_0 C_{HAR}^T} when `har = c(1, week, month)`,
+//' but each block is updated by running sums without building \eqn{X_0}.
+//' Additional orders give additional rolling mean blocks.
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Eigen::MatrixXd build_har_design(Eigen::MatrixXd y, Eigen::VectorXi har, bool include_mean) {
+	if (har.minCoeff() < 1) {
+		Rcpp::stop("Every order in 'har' should be larger than 0.");
+	}
+	if (har.maxCoeff() >= y.rows()) {
+		Rcpp::stop("The largest order in 'har' should be smaller than the number of observations.");
+	}
+	return bvhar::build_har_x0(y, har, include_mean);
+}
+
 //' Building a Linear Transformation Matrix for Vector HAR
 //' 
 //' This function produces a linear transformation matrix for VHAR for given dimension.
@@ -1,4 +1,5 @@
 #include "bvharsim.h"
+#include "bvharomp.h"
 
 //' Generate Multivariate Normal Random Vector
 //' 
@@ -206,8 +207,8 @@ Eigen::MatrixXd sim_iw_tri(Eigen::MatrixXd mat_scale, double shape) {
   // cholesky decomposition (lower triangular)
   Eigen::LLT<Eigen::MatrixXd> lltOfscale(mat_scale);
   Eigen::MatrixXd chol_scale = lltOfscale.matrixL();
-  // lower triangular
-  Eigen::MatrixXd chol_res = chol_scale * mat_bartlett.inverse().transpose();
+  // lower triangular: A^T = Q^(-1) L^T by triangular solve
+  Eigen::MatrixXd chol_res = mat_bartlett.triangularView<Eigen::Upper>().solve(chol_scale.transpose()).transpose();
   return chol_res;
 }
 
@@ -266,21 +267,68 @@ Rcpp::List sim_mniw(int num_sim,
   if (dim_iw != mat_scale.rows()) {
     Rcpp::stop("Invalid 'mat_scale' dimension.");
   }
-  Eigen::MatrixXd chol_res(dim_iw, dim_iw);
-  Eigen::MatrixXd mat_scale_v(dim_iw, dim_iw);
+  bvhar::MniwSampler mniw(mat_mean, mat_scale_u, mat_scale, shape); // factorize U and Psi once
+  Eigen::MatrixXd mn_draw(nrow_mn, ncol_mn);
+  Eigen::MatrixXd iw_draw(dim_iw, dim_iw);
   // result matrices: bind in column wise
   Eigen::MatrixXd res_mn(nrow_mn, num_sim * ncol_mn); // [Y1, Y2, ..., Yn]
   Eigen::MatrixXd res_iw(dim_iw, num_sim * dim_iw); // [Sigma1, Sigma2, ... Sigma2]
   for (int i = 0; i < num_sim; i++) {
-    chol_res = sim_iw_tri(mat_scale, shape);
-    mat_scale_v = chol_res * chol_res.transpose();
-    res_iw.block(0, i * dim_iw, dim_iw, dim_iw) = mat_scale_v;
-    // MN(mat_mean, mat_scale_u, mat_scale_v)
-    res_mn.block(0, i * ncol_mn, nrow_mn, ncol_mn) = sim_matgaussian(
-      mat_mean, 
-      mat_scale_u, 
-      mat_scale_v
-    );
+    mniw.draw(mn_draw, iw_draw);
+    res_mn.middleCols(i * ncol_mn, ncol_mn) = mn_draw;
+    res_iw.middleCols(i * dim_iw, dim_iw) = iw_draw;
+  }
+  return Rcpp::List::create(
+    Rcpp::Named("mn") = res_mn,
+    Rcpp::Named("iw") = res_iw
+  );
+}
+
+//' Generate Normal-IW Random Family in Parallel
+//' 
+//' This function samples normal inverse-wishart matrices with separate RNG stream for each draw.
+//' 
+//' @param num_sim Number to generate
+//' @param mat_mean Mean matrix of MN
+//' @param mat_scale_u First scale matrix of MN
+//' @param mat_scale Scale matrix of IW
+//' @param shape Shape of IW
+//' @param seed_sim Seed for each draw
+//' @param nthreads Number of threads
+//' @details
+//' Same as [sim_mniw()], but the draws are generated in parallel.
+//' Since each draw has its own seed, the result does not depend on `nthreads`.
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List sim_mniw_batch(int num_sim,
+                          Eigen::MatrixXd mat_mean,
+                          Eigen::MatrixXd mat_scale_u,
+                          Eigen::MatrixXd mat_scale,
+                          double shape,
+                          Eigen::VectorXi seed_sim,
+                          int nthreads) {
+  if (seed_sim.size() != num_sim) {
+    Rcpp::stop("Length of 'seed_sim' should be 'num_sim'.");
+  }
+  int ncol_mn = mat_mean.cols();
+  int nrow_mn = mat_mean.rows();
+  int dim_iw = mat_scale.cols();
+  if (dim_iw != mat_scale.rows()) {
+    Rcpp::stop("Invalid 'mat_scale' dimension.");
+  }
+  bvhar::MniwSampler mniw(mat_mean, mat_scale_u, mat_scale, shape);
+  Eigen::MatrixXd res_mn(nrow_mn, num_sim * ncol_mn);
+  Eigen::MatrixXd res_iw(dim_iw, num_sim * dim_iw);
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(nthreads)
+#endif
+  for (int i = 0; i < num_sim; i++) {
+    boost::random::mt19937 rng(static_cast<unsigned int>(seed_sim[i]));
+    Eigen::MatrixXd mn_draw(nrow_mn, ncol_mn);
+    Eigen::MatrixXd iw_draw(dim_iw, dim_iw);
+    mniw.draw(mn_draw, iw_draw, rng);
+    res_mn.middleCols(i * ncol_mn, ncol_mn) = mn_draw;
+    res_iw.middleCols(i * dim_iw, dim_iw) = iw_draw;
   }
   return Rcpp::List::create(
     Rcpp::Named("mn") = res_mn,
@@ -89,10 +89,9 @@ Rcpp::List estimate_hierachical_niw(int num_iter, int num_burn, Eigen::MatrixXd
   prevprior[0] = init_lambda;
   prevprior.segment(1, dim) = init_psi;
   Eigen::VectorXd candprior = Eigen::VectorXd::Zero(1 + dim);
-  Rcpp::List posterior_draw = Rcpp::List::create(
-    Rcpp::Named("mn") = Eigen::MatrixXd::Zero(dim_design, dim),
-    Rcpp::Named("iw") = Eigen::MatrixXd::Zero(dim, dim)
-  );
+  bvhar::MniwSampler mniw(mn_mean, mn_prec.inverse(), iw_scale, posterior_shape); // posterior does not change over iterations
+  Eigen::MatrixXd coef_draw(dim_design, dim);
+  Eigen::MatrixXd sig_draw(dim, dim);
   double numerator = 0;
   double denom = 0;
   bvhar::bvharprogress bar(num_iter, display_progress);
@@ -132,9 +131,9 @@ Rcpp::List estimate_hierachical_niw(int num_iter, int num_burn, Eigen::MatrixXd
       psi_record.row(i) = psi_record.row(i - 1);
     }
     // Draw coef and Sigma
-    posterior_draw = sim_mniw(1, mn_mean, mn_prec.inverse(), iw_scale, posterior_shape);
-		coef_record.row(i - 1) = bvhar::vectorize_eigen(Rcpp::as<Eigen::MatrixXd>(posterior_draw["mn"]));
-    sig_record.block((i - 1) * dim, 0, dim, dim) = Rcpp::as<Eigen::MatrixXd>(posterior_draw["iw"]);
+    mniw.draw(coef_draw, sig_draw);
+		coef_record.row(i - 1) = bvhar::vectorize_eigen(coef_draw);
+    sig_record.block((i - 1) * dim, 0, dim, dim) = sig_draw;
   }
   return Rcpp::List::create(
     Rcpp::Named("lambda_record") = lam_record.tail(num_iter - num_burn),
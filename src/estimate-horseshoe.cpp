@@ -1,5 +1,5 @@
 #include "mcmchs.h"
-#include "bvharinterrupt.h"
+#include "bvharmcmc.h"
 
 //' Gibbs Sampler for Horseshoe BVAR SUR Parameterization
 //' 
@@ -18,13 +18,16 @@
 //' @param grp_id Unique group id
 //' @param grp_mat Group matrix
 //' @param fast Fast sampling?
+//' @param param_converge Convergence check specification. Empty list turns off the check.
+//' @param param_checkpoint Checkpoint specification. Empty list turns off the checkpoint.
+//' @param param_summary Streaming summary specification. Empty list returns the retained draws.
 //' @param seed_chain Seed for each chain
 //' @param display_progress Progress bar
 //' @param nthreads Number of threads for openmp
 //' @noRd
 // [[Rcpp::export]]
 Rcpp::List estimate_sur_horseshoe(int num_chains, int num_iter, int num_burn, int thin,
-                                  Eigen::MatrixXd x, Eigen::MatrixXd y,
+                                  const Eigen::Map<Eigen::MatrixXd> x, const Eigen::Map<Eigen::MatrixXd> y,
                                   Eigen::VectorXd init_local,
                                   Eigen::VectorXd init_global,
                                   double init_sigma,
@@ -32,15 +35,19 @@ Rcpp::List estimate_sur_horseshoe(int num_chains, int num_iter, int num_burn, in
                                   Eigen::MatrixXi grp_mat,
                                   int blocked_gibbs,
                                   bool fast,
+																	Rcpp::List param_converge,
+																	Rcpp::List param_checkpoint,
+																	Rcpp::List param_summary,
 																	Eigen::VectorXi seed_chain,
                                   bool display_progress, int nthreads) {
-  #ifdef _OPENMP
-		Eigen::setNbThreads(nthreads);
-	#endif
+	bvhar::ThreadBudget budget(nthreads, num_chains, false);
+	bvhar::SummarySpec summary_spec(param_summary);
+#ifdef _OPENMP
+	Eigen::setNbThreads(budget.eigenThreads());
+#endif
 	std::vector<std::unique_ptr<bvhar::McmcHs>> hs_objs(num_chains);
-	std::vector<Rcpp::List> res(num_chains);
 	bvhar::HsParams hs_params(
-		num_iter, x, y, init_local, init_global, init_sigma,
+		num_iter, num_burn, thin, summary_spec, x, y, init_local, init_global, init_sigma,
 		grp_id, grp_mat
 	);
 	switch (blocked_gibbs) {
@@ -61,42 +68,12 @@ Rcpp::List estimate_sur_horseshoe(int num_chains, int num_iter, int num_burn, in
 			hs_objs[i] = std::unique_ptr<bvhar::McmcHs>(new bvhar::BlockHs(hs_params, static_cast<unsigned int>(seed_chain[i])));
 		}
 	}
-  // Start Gibbs sampling-----------------------------------
-	auto run_gibbs = [&](int chain) {
-		bvhar::bvharprogress bar(num_iter, display_progress);
-		bvhar::bvharinterrupt();
-		for (int i = 1; i < num_iter + 1; i++) {
-			if (bvhar::bvharinterrupt::is_interrupted()) {
-			#ifdef _OPENMP
-				#pragma omp critical
-			#endif
-				{
-					res[chain] = hs_objs[chain]->returnRecords(0, 1);
-				}
-				break;
-			}
-			bar.increment();
-			if (display_progress) {
-				bar.update();
-			}
-			hs_objs[chain]->doPosteriorDraws(); // alpha -> sigma -> nuj -> xi -> lambdaj -> tau
-		}
-	#ifdef _OPENMP
-		#pragma omp critical
-	#endif
-		{
-			res[chain] = hs_objs[chain]->returnRecords(num_burn, thin);
-		}
-	};
-	if (num_chains == 1) {
-		run_gibbs(0);
-	} else {
-	#ifdef _OPENMP
-		#pragma omp parallel for num_threads(nthreads)
-	#endif
-		for (int chain = 0; chain < num_chains; chain++) {
-			run_gibbs(chain);
-		}
+	// Start Gibbs sampling-----------------------------------
+	bvhar::McmcMonitor monitor(param_converge, num_iter, num_burn, thin, x.cols() * y.cols());
+	bvhar::McmcCheckpoint checkpoint(param_checkpoint, num_iter);
+	Rcpp::List res = Rcpp::wrap(bvhar::run_mcmc_chains(hs_objs, monitor, checkpoint, budget, num_iter, display_progress));
+	if (monitor.isActive()) {
+		res.attr("convergence") = monitor.returnDiagnostic();
 	}
-	return Rcpp::wrap(res);
+	return res;
 }
@@ -1,5 +1,5 @@
 #include "mcmcssvs.h"
-#include "bvharinterrupt.h"
+#include "bvharmcmc.h"
 
 //' BVAR(p) SSVS by Gibbs Sampler
 //' 
@@ -33,6 +33,9 @@
 //' @param mean_non Prior mean of unrestricted coefficients
 //' @param sd_non Standard deviance for unrestricted coefficients
 //' @param include_mean Add constant term
+//' @param param_converge Convergence check specification. Empty list turns off the check.
+//' @param param_checkpoint Checkpoint specification. Empty list turns off the checkpoint.
+//' @param param_summary Streaming summary specification. Empty list returns the retained draws.
 //' @param seed_chain Seed for each chain
 //' @param init_gibbs Set custom initial values for Gibbs sampler
 //' @param display_progress Progress bar
@@ -40,7 +43,7 @@
 //' @noRd
 // [[Rcpp::export]]
 Rcpp::List estimate_bvar_ssvs(int num_chains, int num_iter, int num_burn, int thin,
-                              Eigen::MatrixXd x, Eigen::MatrixXd y, 
+                              const Eigen::Map<Eigen::MatrixXd> x, const Eigen::Map<Eigen::MatrixXd> y, 
                               Eigen::VectorXd init_coef,
                               Eigen::VectorXd init_chol_diag, Eigen::VectorXd init_chol_upper,
                               Eigen::VectorXd init_coef_dummy, Eigen::VectorXd init_chol_dummy,
@@ -53,17 +56,21 @@ Rcpp::List estimate_bvar_ssvs(int num_chains, int num_iter, int num_burn, int th
                               Eigen::MatrixXi grp_mat,
                               Eigen::VectorXd mean_non, double sd_non,
                               bool include_mean,
+															Rcpp::List param_converge,
+															Rcpp::List param_checkpoint,
+															Rcpp::List param_summary,
 															Eigen::VectorXi seed_chain,
                               bool init_gibbs,
                               bool display_progress, int nthreads) {
+	bvhar::ThreadBudget budget(nthreads, num_chains, false);
+	bvhar::SummarySpec summary_spec(param_summary);
 #ifdef _OPENMP
-  Eigen::setNbThreads(nthreads);
+	Eigen::setNbThreads(budget.eigenThreads());
 #endif
 	std::vector<std::unique_ptr<bvhar::McmcSsvs>> mcmc_objs(num_chains);
-	std::vector<Rcpp::List> res(num_chains);
 	for (int i = 0; i < num_chains; i++) {
 		mcmc_objs[i] = std::unique_ptr<bvhar::McmcSsvs>(new bvhar::McmcSsvs(
-			num_iter, x, y,
+			num_iter, num_burn, thin, summary_spec, x, y,
 			init_coef, init_chol_diag, init_chol_upper,
 			init_coef_dummy, init_chol_dummy,
 			coef_spike, coef_slab, coef_slab_weight,
@@ -76,42 +83,12 @@ Rcpp::List estimate_bvar_ssvs(int num_chains, int num_iter, int num_burn, int th
 			static_cast<unsigned int>(seed_chain[i])
 		));
 	}
-	// Start Gibbs sampling-----------------------------------------
-	auto run_gibbs = [&](int chain) {
-		bvhar::bvharprogress bar(num_iter, display_progress);
-		bvhar::bvharinterrupt();
-		for (int i = 0; i < num_iter; i++) {
-			if (bvhar::bvharinterrupt::is_interrupted()) {
-			#ifdef _OPENMP
-				#pragma omp critical
-			#endif
-				{
-					res[chain] = mcmc_objs[chain]->returnRecords(0, 1);
-				}
-				break;
-			}
-			bar.increment();
-			if (display_progress) {
-				bar.update();
-			}
-			mcmc_objs[chain]->doPosteriorDraws(); // Psi -> eta -> omega -> alpha -> gamma -> p
-		}
-	#ifdef _OPENMP
-		#pragma omp critical
-	#endif
-		{
-			res[chain] = mcmc_objs[chain]->returnRecords(num_burn, thin);
-		}
-	};
-	if (num_chains == 1) {
-		run_gibbs(0);
-	} else {
-	#ifdef _OPENMP
-		#pragma omp parallel for num_threads(nthreads)
-	#endif
-		for (int chain = 0; chain < num_chains; chain++) {
-			run_gibbs(chain);
-		}
+	// Start Gibbs sampling-----------------------------------
+	bvhar::McmcMonitor monitor(param_converge, num_iter, num_burn, thin, x.cols() * y.cols());
+	bvhar::McmcCheckpoint checkpoint(param_checkpoint, num_iter);
+	Rcpp::List res = Rcpp::wrap(bvhar::run_mcmc_chains(mcmc_objs, monitor, checkpoint, budget, num_iter, display_progress));
+	if (monitor.isActive()) {
+		res.attr("convergence") = monitor.returnDiagnostic();
 	}
-	return Rcpp::wrap(res);
+	return res;
 }
@@ -1,5 +1,5 @@
 #include "mcmcsv.h"
-#include "bvharinterrupt.h"
+#include "bvharmcmc.h"
 
 //' VAR-SV by Gibbs Sampler
 //' 
@@ -18,6 +18,11 @@
 //' @param grp_id Unique group id
 //' @param grp_mat Group matrix
 //' @param include_mean Constant term
+//' @param param_converge Convergence check specification. Empty list turns off the check.
+//' @param param_checkpoint Checkpoint specification. Empty list turns off the checkpoint.
+//' @param param_summary Streaming summary specification. Empty list returns the retained draws.
+//' @param timing Measure elapsed time of each Gibbs step
+//' @param structural Draw the coefficients in recursive structural form
 //' @param seed_chain Seed for each chain
 //' @param display_progress Progress bar
 //' @param nthreads Number of threads for openmp
@@ -25,7 +30,7 @@
 //' @noRd
 // [[Rcpp::export]]
 Rcpp::List estimate_var_sv(int num_chains, int num_iter, int num_burn, int thin,
-                           Eigen::MatrixXd x, Eigen::MatrixXd y,
+                           const Eigen::Map<Eigen::MatrixXd> x, const Eigen::Map<Eigen::MatrixXd> y,
 													 Rcpp::List param_sv,
 													 Rcpp::List param_prior,
 													 Rcpp::List param_intercept,
@@ -34,17 +39,23 @@ Rcpp::List estimate_var_sv(int num_chains, int num_iter, int num_burn, int thin,
                            Eigen::VectorXi grp_id,
                            Eigen::MatrixXi grp_mat,
                            bool include_mean,
+													 Rcpp::List param_converge,
+													 Rcpp::List param_checkpoint,
+													 Rcpp::List param_summary,
+													 bool timing,
+													 bool structural,
 													 Eigen::VectorXi seed_chain,
                            bool display_progress, int nthreads) {
+	bvhar::ThreadBudget budget(nthreads, num_chains);
+	bvhar::SummarySpec summary_spec(param_summary);
 #ifdef _OPENMP
-  Eigen::setNbThreads(nthreads);
+	Eigen::setNbThreads(budget.eigenThreads());
 #endif
 	std::vector<std::unique_ptr<bvhar::McmcSv>> sv_objs(num_chains);
-	std::vector<Rcpp::List> res(num_chains);
 	switch (prior_type) {
 		case 1: {
 			bvhar::MinnParams minn_params(
-				num_iter, x, y,
+				num_iter, num_burn, thin, summary_spec, x, y,
 				param_sv, param_prior,
 				param_intercept, include_mean
 			);
@@ -57,7 +68,7 @@ Rcpp::List estimate_var_sv(int num_chains, int num_iter, int num_burn, int thin,
 		}
 		case 2: {
 			bvhar::SsvsParams ssvs_params(
-				num_iter, x, y,
+				num_iter, num_burn, thin, summary_spec, x, y,
 				param_sv,
 				grp_id, grp_mat,
 				param_prior,
@@ -73,7 +84,7 @@ Rcpp::List estimate_var_sv(int num_chains, int num_iter, int num_burn, int thin,
 		}
 		case 3: {
 			bvhar::HorseshoeParams horseshoe_params(
-				num_iter, x, y,
+				num_iter, num_burn, thin, summary_spec, x, y,
 				param_sv,
 				grp_id, grp_mat,
 				param_intercept, include_mean
@@ -86,42 +97,27 @@ Rcpp::List estimate_var_sv(int num_chains, int num_iter, int num_burn, int thin,
 			break;
 		}
 	}
-  // Start Gibbs sampling-----------------------------------
-	auto run_gibbs = [&](int chain) {
-		bvhar::bvharprogress bar(num_iter, display_progress);
-		bvhar::bvharinterrupt();
-		for (int i = 0; i < num_iter; i++) {
-			if (bvhar::bvharinterrupt::is_interrupted()) {
-			#ifdef _OPENMP
-				#pragma omp critical
-			#endif
-				{
-					res[chain] = sv_objs[chain]->returnRecords(0, 1);
-				}
-				break;
-			}
-			bar.increment();
-			if (display_progress) {
-				bar.update();
-			}
-			sv_objs[chain]->doPosteriorDraws(); // alpha -> a -> h -> sigma_h -> h0
-		}
-	#ifdef _OPENMP
-		#pragma omp critical
-	#endif
-		{
-			res[chain] = sv_objs[chain]->returnRecords(num_burn, thin);
-		}
-	};
-	if (num_chains == 1) {
-		run_gibbs(0);
-	} else {
-	#ifdef _OPENMP
-		#pragma omp parallel for num_threads(nthreads)
-	#endif
-		for (int chain = 0; chain < num_chains; chain++) {
-			run_gibbs(chain);
+	for (int i = 0; i < num_chains; i++) {
+		sv_objs[i]->setIntraThreads(budget.intraThreads(i));
+		sv_objs[i]->setTiming(timing);
+		sv_objs[i]->setStructural(structural);
+	}
+	// Start Gibbs sampling-----------------------------------
+	bvhar::McmcMonitor monitor(param_converge, num_iter, num_burn, thin, x.cols() * y.cols());
+	bvhar::McmcCheckpoint checkpoint(param_checkpoint, num_iter);
+	Rcpp::List res = Rcpp::wrap(bvhar::run_mcmc_chains(sv_objs, monitor, checkpoint, budget, num_iter, display_progress, budget.lockstepSize()));
+	if (monitor.isActive()) {
+		res.attr("convergence") = monitor.returnDiagnostic();
+	}
+	if (timing) {
+		Eigen::MatrixXd stage_time(num_chains, bvhar::McmcSv::stageNames().size());
+		for (int i = 0; i < num_chains; i++) {
+			stage_time.row(i) = sv_objs[i]->returnTiming();
 		}
+		res.attr("timing") = Rcpp::List::create(
+			Rcpp::Named("stage") = bvhar::McmcSv::stageNames(),
+			Rcpp::Named("elapsed") = stage_time
+		);
 	}
-	return Rcpp::wrap(res);
+	return res;
 }
@@ -1,4 +1,5 @@
 #include "ols.h"
+#include "bvharstructural.h"
 
 //' Compute VAR(p) Coefficient Matrices and Fitted Values
 //' 
@@ -90,30 +91,10 @@ Rcpp::List infer_var(Rcpp::List object) {
 //' @noRd
 // [[Rcpp::export]]
 Eigen::MatrixXd VARcoeftoVMA(Eigen::MatrixXd var_coef, int var_lag, int lag_max) {
-  int dim = var_coef.cols(); // m
   if (lag_max < 1) {
     Rcpp::stop("'lag_max' must larger than 0");
   }
-  int ma_rows = dim * (lag_max + 1);
-  int num_full_arows = ma_rows;
-  if (lag_max < var_lag) {
-    num_full_arows = dim * var_lag; // for VMA coefficient q < VAR(p)
-  }
-  Eigen::MatrixXd FullA = Eigen::MatrixXd::Zero(num_full_arows, dim); // same size with VMA coefficient matrix
-  FullA.block(0, 0, dim * var_lag, dim) = var_coef.block(0, 0, dim * var_lag, dim); // fill first mp row with VAR coefficient matrix
-  Eigen::MatrixXd Im = Eigen::MatrixXd::Identity(dim, dim); // identity matrix
-  Eigen::MatrixXd ma = Eigen::MatrixXd::Zero(ma_rows, dim); // VMA [W1^T, W2^T, ..., W(lag_max)^T]^T, ma_rows = m * lag_max
-  ma.block(0, 0, dim, dim) = Im; // W0 = Im
-  ma.block(dim, 0, dim, dim) = FullA.block(0, 0, dim, dim) * ma.block(0, 0, dim, dim); // W1^T = B1^T * W1^T
-  if (lag_max == 1) {
-    return ma;
-  }
-  for (int i = 2; i < (lag_max + 1); i++) { // from W2: m-th row
-    for (int k = 0; k < i; k++) {
-      ma.block(i * dim, 0, dim, dim) += FullA.block(k * dim, 0, dim, dim) * ma.block((i - k - 1) * dim, 0, dim, dim); // Wi = sum(W(i - k)^T * Bk^T)
-    }
-  }
-  return ma;
+  return bvhar::build_vma(var_coef, var_lag, lag_max);
 }
 
 //' Convert VAR to VMA(infinite)
@@ -1,4 +1,5 @@
 #include "ols.h"
+#include "bvharstructural.h"
 
 //' Compute Vector HAR Coefficient Matrices and Fitted Values
 //' 
@@ -70,27 +71,11 @@ Rcpp::List infer_vhar(Rcpp::List object) {
 //' @noRd
 // [[Rcpp::export]]
 Eigen::MatrixXd VHARcoeftoVMA(Eigen::MatrixXd vhar_coef, Eigen::MatrixXd HARtrans_mat, int lag_max, int month) {
-  int dim = vhar_coef.cols(); // dimension of time series
   Eigen::MatrixXd coef_mat = HARtrans_mat.transpose() * vhar_coef; // bhat = tilde(T)^T * Phi
   if (lag_max < 1) {
     Rcpp::stop("'lag_max' must larger than 0");
   }
-  int ma_rows = dim * (lag_max + 1);
-  int num_full_arows = ma_rows;
-  if (lag_max < month) num_full_arows = month * dim; // for VMA coefficient q < VAR(p)
-  Eigen::MatrixXd FullA = Eigen::MatrixXd::Zero(num_full_arows, dim); // same size with VMA coefficient matrix
-  FullA.block(0, 0, month * dim, dim) = coef_mat.block(0, 0, month * dim, dim); // fill first mp row with VAR coefficient matrix
-  Eigen::MatrixXd Im = Eigen::MatrixXd::Identity(dim, dim); // identity matrix
-  Eigen::MatrixXd ma = Eigen::MatrixXd::Zero(ma_rows, dim); // VMA [W1^T, W2^T, ..., W(lag_max)^T]^T, ma_rows = m * lag_max
-  ma.block(0, 0, dim, dim) = Im; // W0 = Im
-  ma.block(dim, 0, dim, dim) = FullA.block(0, 0, dim, dim) * ma.block(0, 0, dim, dim); // W1^T = B1^T * W1^T
-  if (lag_max == 1) return ma;
-  for (int i = 2; i < (lag_max + 1); i++) { // from W2: m-th row
-    for (int k = 0; k < i; k++) {
-      ma.block(i * dim, 0, dim, dim) += FullA.block(k * dim, 0, dim, dim) * ma.block((i - k - 1) * dim, 0, dim, dim); // Wi = sum(W(i - k)^T * Bk^T)
-    }
-  }
-  return ma;
+  return bvhar::build_vma(coef_mat, month, lag_max);
 }
 
 //' Convert VHAR to VMA(infinite)
@@ -1,5 +1,7 @@
 #include "bvharomp.h"
 #include "bvhardraw.h"
+#include "bvharlag.h"
+#include "bvharforecast.h"
 
 //' Forecasting BVAR(p)
 //' 
@@ -42,7 +44,6 @@ Rcpp::List forecast_bvar(Rcpp::List object, int step, int num_sim) {
   double posterior_shape = object["iw_shape"]; // posterior shape of IW
   int dim = object["m"]; // dimension of time series
   int var_lag = object["p"]; // VAR(p)
-  int num_design = object["obs"]; // s = n - p
   int dim_design = object["df"];
   // (A, Sig) ~ MNIW
   Rcpp::List coef_and_sig = sim_mniw(
@@ -58,19 +59,15 @@ Rcpp::List forecast_bvar(Rcpp::List object, int step, int num_sim) {
   Eigen::MatrixXd point_forecast(step, dim); // h x m matrix
   Eigen::MatrixXd density_forecast(step, num_sim * dim); // h x Bm matrix
   Eigen::MatrixXd predictive_distn(step, num_sim * dim); // h x Bm matrix
-  Eigen::MatrixXd last_pvec(1, dim_design); // vectorize the last p observation and include 1
-  Eigen::MatrixXd tmp_vec(1, (var_lag - 1) * dim);
+  bvhar::VarLag lag_state(response_mat, var_lag, dim_design == var_lag * dim + 1); // [y(n)^T, ..., y(n - p + 1)^T, 1]
+  Eigen::VectorXd last_pvec = lag_state.getLag();
   Eigen::VectorXd sig_closed(step); // se^2 for each forecast (except Sigma2 part, i.e. closed form)
   for (int i = 0; i < step; i++) {
     sig_closed(i) = 1.0;
   }
-  last_pvec(0, dim_design - 1) = 1.0;
-  for (int i = 0; i < var_lag; i++) {
-    last_pvec.block(0, i * dim, 1, dim) = response_mat.block(num_design - 1 - i, 0, 1, dim);
-  }
-  sig_closed.block(0, 0, 1, 1) += last_pvec * posterior_prec_mat.inverse() * last_pvec.transpose();
-  point_forecast.block(0, 0, 1, dim) = last_pvec * posterior_mean_mat; // y(n + 1)^T = [y(n)^T, ..., y(n - p + 1)^T, 1] %*% Ahat
-  density_forecast.block(0, 0, 1, num_sim * dim) = last_pvec * coef_gen; // use A(simulated)
+  sig_closed[0] += last_pvec.transpose() * posterior_mn_scale_u * last_pvec;
+  point_forecast.row(0) = lag_state.multiply(posterior_mean_mat); // y(n + 1)^T = [y(n)^T, ..., y(n - p + 1)^T, 1] %*% Ahat
+  density_forecast.row(0) = lag_state.multiply(coef_gen); // use A(simulated)
   // one-step ahead forecasting
   Eigen::MatrixXd sig_mat = sig_gen.block(0, 0, dim, dim); // First Sighat
   for (int b = 0; b < num_sim; b++) {
@@ -88,13 +85,12 @@ Rcpp::List forecast_bvar(Rcpp::List object, int step, int num_sim) {
   }
   // Next h - 1: recursively
   for (int i = 1; i < step; i++) {
-    tmp_vec = last_pvec.block(0, 0, 1, (var_lag - 1) * dim); // remove the last m (except 1)
-    last_pvec.block(0, dim, 1, (var_lag - 1) * dim) = tmp_vec;
-    last_pvec.block(0, 0, 1, dim) = point_forecast.block(i - 1, 0, 1, dim);
-    sig_closed.block(i, 0, 1, 1) += last_pvec * posterior_prec_mat.inverse() * last_pvec.transpose();
-    point_forecast.block(i, 0, 1, dim) = last_pvec * posterior_mean_mat; // y(n + 2)^T = [yhat(n + 1)^T, y(n)^T, ... y(n - p + 2)^T, 1] %*% Ahat
+    lag_state.update(point_forecast.row(i - 1).transpose()); // yhat(n + 1) enters as the latest lag
+    last_pvec = lag_state.getLag();
+    sig_closed[i] += last_pvec.transpose() * posterior_mn_scale_u * last_pvec;
+    point_forecast.row(i) = lag_state.multiply(posterior_mean_mat); // y(n + 2)^T = [yhat(n + 1)^T, y(n)^T, ... y(n - p + 2)^T, 1] %*% Ahat
     // Predictive distribution
-    density_forecast.block(i, 0, 1, num_sim * dim) = last_pvec * coef_gen;
+    density_forecast.row(i) = lag_state.multiply(coef_gen);
     for (int b = 0; b < num_sim; b++) {
       sig_mat = sig_gen.block(0, b * dim, dim, dim); // b-th Sighat
       predictive_distn.block(i, b * dim, 1, dim) = sim_matgaussian(
@@ -129,16 +125,10 @@ Eigen::MatrixXd forecast_bvarssvs(int num_chains, int var_lag, int step,
 																	Eigen::MatrixXd psi_record) {
   int num_sim = num_chains > 1 ? alpha_record.rows() / num_chains : alpha_record.rows();
   int dim = response_mat.cols();
-  int num_design = response_mat.rows();
 	int num_coef = dim_design * dim;
   Eigen::VectorXd density_forecast(dim);
   Eigen::MatrixXd predictive_distn(step * num_chains, num_sim * dim);
-  Eigen::VectorXd last_pvec(dim_design);
-  Eigen::VectorXd tmp_vec(dim_design - dim);
-  last_pvec[dim_design - 1] = 1.0;
-  for (int i = 0; i < var_lag; i++) {
-    last_pvec.segment(i * dim, dim) = response_mat.row(num_design - 1 - i);
-  }
+  Eigen::MatrixXd coef_mat(dim_design, dim);
   Eigen::MatrixXd chol_factor(dim, dim);
   Eigen::MatrixXd sig_cycle(dim, dim);
 	Eigen::MatrixXd alpha_chain(num_sim, num_coef);
@@ -149,27 +139,14 @@ Eigen::MatrixXd forecast_bvarssvs(int num_chains, int var_lag, int step,
 		eta_chain = eta_record.middleRows(chain * num_sim, num_sim);
 		psi_chain = psi_record.middleRows(chain * num_sim, num_sim);
 		for (int b = 0; b < num_sim; b++) {
-			density_forecast = last_pvec.transpose() * bvhar::unvectorize(alpha_chain.row(b).eval(), dim);
+			bvhar::VarLag lag_state(response_mat, var_lag, dim_design == var_lag * dim + 1); // each draw has its own recursion
+			coef_mat = bvhar::unvectorize(alpha_chain.row(b).eval(), dim);
 			chol_factor = bvhar::build_chol(psi_chain.row(b), eta_chain.row(b));
 			sig_cycle = (chol_factor * chol_factor.transpose()).inverse();
-			predictive_distn.block(chain * step, b * dim, 1, dim) = sim_mgaussian_chol(1, density_forecast, sig_cycle);
-		}
-	}
-  if (step == 1) {
-    return predictive_distn;
-  }
-	for (int chain = 0; chain < num_chains; chain++) {
-		alpha_chain = alpha_record.middleRows(chain * num_sim, num_sim);
-		eta_chain = eta_record.middleRows(chain * num_sim, num_sim);
-		psi_chain = psi_record.middleRows(chain * num_sim, num_sim);
-		for (int i = 1; i < step; i++) {
-			for (int b = 0; b < num_sim; b++) {
-				tmp_vec = last_pvec.head(dim_design - dim);
-				last_pvec << density_forecast, tmp_vec;
-				density_forecast = last_pvec.transpose() * bvhar::unvectorize(alpha_chain.row(b).eval(), dim);
-				chol_factor = bvhar::build_chol(psi_chain.row(b), eta_chain.row(b));
-				sig_cycle = (chol_factor * chol_factor.transpose()).inverse();
+			for (int i = 0; i < step; i++) {
+				density_forecast = lag_state.multiply(coef_mat).transpose();
 				predictive_distn.block(chain * step + i, b * dim, 1, dim) = sim_mgaussian_chol(1, density_forecast, sig_cycle);
+				lag_state.update(density_forecast);
 			}
 		}
 	}
@@ -194,16 +171,10 @@ Eigen::MatrixXd forecast_bvarhs(int num_chains, int var_lag, int step,
 																Eigen::VectorXd sigma_record) {
   int num_sim = num_chains > 1 ? alpha_record.rows() / num_chains : alpha_record.rows();
   int dim = response_mat.cols();
-  int num_design = response_mat.rows();
 	int num_coef = dim_design * dim;
   Eigen::VectorXd density_forecast(dim);
   Eigen::MatrixXd predictive_distn(step * num_chains, num_sim * dim);
-  Eigen::VectorXd last_pvec(dim_design);
-	Eigen::VectorXd tmp_vec(dim_design - dim);
-  last_pvec[dim_design - 1] = 1.0;
-  for (int i = 0; i < var_lag; i++) {
-    last_pvec.segment(i * dim, dim) = response_mat.row(num_design - 1 - i);
-  }
+  Eigen::MatrixXd coef_mat(dim_design, dim);
   Eigen::MatrixXd sig_cycle(dim, dim);
 	Eigen::MatrixXd alpha_chain(num_sim, num_coef);
 	Eigen::VectorXd sig_chain(num_sim);
@@ -211,26 +182,14 @@ Eigen::MatrixXd forecast_bvarhs(int num_chains, int var_lag, int step,
 		alpha_chain = alpha_record.middleRows(chain * num_sim, num_sim);
 		sig_chain = sigma_record.segment(chain * num_sim, num_sim);
 		for (int b = 0; b < num_sim; b++) {
-			density_forecast = last_pvec.transpose() * bvhar::unvectorize(alpha_chain.row(b).eval(), dim);
+			bvhar::VarLag lag_state(response_mat, var_lag, dim_design == var_lag * dim + 1); // each draw has its own recursion
+			coef_mat = bvhar::unvectorize(alpha_chain.row(b).eval(), dim);
 			sig_cycle.setIdentity();
 			sig_cycle *= sig_chain[b];
-			predictive_distn.block(chain * step, b * dim, 1, dim) = sim_mgaussian_chol(1, density_forecast, sig_cycle);
-		}
-	}
-  if (step == 1) {
-		return predictive_distn;
-  }
-	for (int chain = 0; chain < num_chains; chain++) {
-		alpha_chain = alpha_record.middleRows(chain * num_sim, num_sim);
-		sig_chain = sigma_record.segment(chain * num_sim, num_sim);
-		for (int i = 1; i < step; i++) {
-			for (int b = 0; b < num_sim; b++) {
-				tmp_vec = last_pvec.head(dim_design - dim);
-				last_pvec << density_forecast, tmp_vec;
-				density_forecast = last_pvec.transpose() * bvhar::unvectorize(alpha_chain.row(b).eval(), dim);
-				sig_cycle.setIdentity();
-				sig_cycle *= sig_chain[b];
+			for (int i = 0; i < step; i++) {
+				density_forecast = lag_state.multiply(coef_mat).transpose();
 				predictive_distn.block(chain * step + i, b * dim, 1, dim) = sim_mgaussian_chol(1, density_forecast, sig_cycle);
+				lag_state.update(density_forecast);
 			}
 		}
 	}
@@ -248,24 +207,11 @@ Eigen::MatrixXd forecast_bvarhs(int num_chains, int var_lag, int step,
 // [[Rcpp::export]]
 Eigen::MatrixXd forecast_bvarsv(int var_lag, int step, Eigen::MatrixXd response_mat, Eigen::MatrixXd coef_mat) {
   int dim = response_mat.cols();
-  int num_design = response_mat.rows();
-  int dim_design = coef_mat.rows();
   Eigen::MatrixXd point_forecast(step, dim);
-  Eigen::VectorXd last_pvec(dim_design);
-  Eigen::VectorXd tmp_vec((var_lag - 1) * dim);
-  last_pvec[dim_design - 1] = 1.0;
-  for (int i = 0; i < var_lag; i++) {
-    last_pvec.segment(i * dim, dim) = response_mat.row(num_design - 1 - i);
-  }
-  point_forecast.row(0) = last_pvec.transpose() * coef_mat;
-  if (step == 1) {
-    return point_forecast;
-  }
-  for (int i = 1; i < step; i++) {
-    tmp_vec = last_pvec.segment(0, (var_lag - 1) * dim);
-    last_pvec.segment(dim, (var_lag - 1) * dim) = tmp_vec;
-    last_pvec.segment(0, dim) = point_forecast.row(i - 1);
-    point_forecast.row(i) = last_pvec.transpose() * coef_mat;
+  bvhar::VarLag lag_state(response_mat, var_lag, coef_mat.rows() == var_lag * dim + 1);
+  for (int i = 0; i < step; i++) {
+    point_forecast.row(i) = lag_state.multiply(coef_mat);
+    lag_state.update(point_forecast.row(i).transpose());
   }
   return point_forecast;
 }
@@ -287,88 +233,14 @@ Eigen::MatrixXd forecast_bvarsv_density(int num_chains, int var_lag, int step, E
                                    			Eigen::MatrixXd alpha_record, Eigen::MatrixXd h_last_record,
 																				Eigen::MatrixXd a_record, Eigen::MatrixXd sigh_record, bool include_mean) {
   int num_sim = num_chains > 1 ? alpha_record.rows() / num_chains : alpha_record.rows();
-	// int num_sim = alpha_record.rows();
   int dim = response_mat.cols();
-  int num_design = response_mat.rows();
-	int dim_design = include_mean ? var_lag * dim + 1 : var_lag * dim;
-	int num_coef = dim_design * dim;
-	int num_alpha = include_mean ? num_coef - dim : num_coef;
-  Eigen::VectorXd density_forecast(dim);
   Eigen::MatrixXd predictive_distn(step * num_chains, num_sim * dim);
-  Eigen::VectorXd last_pvec(dim_design);
-	Eigen::VectorXd tmp_vec(dim_design - dim);
-  Eigen::VectorXd sv_update(dim);
-  Eigen::MatrixXd sv_cov = Eigen::MatrixXd::Zero(dim, dim);
-  last_pvec[dim_design - 1] = 1.0;
-  for (int i = 0; i < var_lag; i++) {
-    last_pvec.segment(i * dim, dim) = response_mat.row(num_design - 1 - i);
-  }
-	Eigen::MatrixXd coef_mat_record(dim_design, dim); // include constant term
-  Eigen::MatrixXd contem_mat = Eigen::MatrixXd::Zero(dim, dim);
-  Eigen::MatrixXd tvp_lvol = Eigen::MatrixXd::Zero(dim, dim);
-  Eigen::MatrixXd tvp_prec(dim, dim);
-	Eigen::MatrixXd alpha_chain(num_sim, num_coef);
-	Eigen::MatrixXd h_chain(num_sim, dim);
-	Eigen::MatrixXd a_chain(num_sim, dim * (dim - 1) / 2);
-	Eigen::MatrixXd sigh_chain(num_sim, dim);
-	for (int chain = 0; chain < num_chains; chain++) {
-		alpha_chain = alpha_record.middleRows(chain * num_sim, num_sim);
-		h_chain = h_last_record.middleRows(chain * num_sim, num_sim);
-		a_chain = a_record.middleRows(chain * num_sim, num_sim);
-		sigh_chain = sigh_record.middleRows(chain * num_sim, num_sim);
-		for (int b = 0; b < num_sim; b++) {
-			coef_mat_record.topRows(var_lag * dim) = bvhar::unvectorize(alpha_chain.row(b).head(num_alpha).transpose().eval(), dim);
-			if (include_mean) {
-				coef_mat_record.bottomRows(1) = alpha_chain.row(b).tail(dim);
-			}
-			density_forecast = last_pvec.transpose() * coef_mat_record;
-			sv_cov.diagonal() = 1 / sigh_chain.row(b).array(); // covariance of h_t
-			sv_update = bvhar::vectorize_eigen(
-				sim_mgaussian_chol(1, h_chain.row(b), sv_cov)
-			); // h_T+1 = h_T + u_T
-			tvp_lvol.diagonal() = 1 / sv_update.array().exp(); // Dt = diag(exp(h_t))
-			contem_mat = bvhar::build_inv_lower(dim, a_chain.row(b));
-			tvp_prec = contem_mat.transpose() * tvp_lvol * contem_mat; // L^T D_T  L
-			predictive_distn.block(chain * step, b * dim, 1, dim) = sim_mgaussian_chol(
-				1,
-				density_forecast,
-				tvp_prec.inverse()
-			);
-		}
-	}
-  if (step == 1) {
-		return predictive_distn;
-  }
-	for (int chain = 0; chain < num_chains; chain++) {
-		alpha_chain = alpha_record.middleRows(chain * num_sim, num_sim);
-		h_chain = h_last_record.middleRows(chain * num_sim, num_sim);
-		a_chain = a_record.middleRows(chain * num_sim, num_sim);
-		sigh_chain = sigh_record.middleRows(chain * num_sim, num_sim);
-		for (int i = 1; i < step; i++) {
-			for (int b = 0; b < num_sim; b++) {
-				tmp_vec = last_pvec.head(dim_design - dim);
-				last_pvec << density_forecast, tmp_vec;
-				coef_mat_record.topRows(var_lag * dim) = bvhar::unvectorize(alpha_chain.row(b).head(num_alpha).transpose().eval(), dim);
-				if (include_mean) {
-					coef_mat_record.bottomRows(1) = alpha_chain.row(b).tail(dim);
-				}
-				density_forecast = last_pvec.transpose() * coef_mat_record;
-				sv_cov.diagonal() = 1 / sigh_chain.row(b).array();
-				sv_update = bvhar::vectorize_eigen(
-					sim_mgaussian_chol(1, h_chain.row(b), sv_cov)
-				);
-				tvp_lvol.diagonal() = 1 / sv_update.array();
-				contem_mat = bvhar::build_inv_lower(dim, a_chain.row(b));
-				tvp_prec = contem_mat.transpose() * tvp_lvol * contem_mat;
-				predictive_distn.block(chain * step + i, b * dim, 1, dim) = sim_mgaussian_chol(
-					1,
-					density_forecast,
-					tvp_prec.inverse()
-				);
-			}
-		}
-	}
-	return predictive_distn;
+	bvhar::VarLag lag_init(response_mat, var_lag, include_mean);
+	bvhar::dispatch_dim<bvhar::SvDensityForecast>(
+		dim, predictive_distn, lag_init, num_chains, step,
+		alpha_record, h_last_record, a_record, sigh_record, include_mean
+	);
+	return predictive_distn; // rbind(chains), cbind(sims)
 }
 
 //' Out-of-Sample Forecasting of BVAR based on Rolling Window
@@ -1,5 +1,7 @@
 #include "bvharomp.h"
 #include "bvhardraw.h"
+#include "bvharlag.h"
+#include "bvharforecast.h"
 
 //' Forecasting Bayesian VHAR
 //' 
@@ -31,12 +33,8 @@ Rcpp::List forecast_bvharmn(Rcpp::List object, int step, int num_sim) {
   Eigen::MatrixXd posterior_scale = object["iw_scale"]; // Sighat = posterior scale of IW: m x m
   double posterior_shape = object["iw_shape"]; // posterior shape of IW
   Eigen::MatrixXd HARtrans = object["HARtrans"]; // HAR transformation: h x k0, k0 = 22m (+ 1)
-  Eigen::MatrixXd transformed_prec_mat = HARtrans.transpose() * posterior_prec_mat.inverse() * HARtrans; // to compute SE: play a role V in BVAR
   int dim = object["m"]; // dimension of time series
-  int num_design = object["obs"]; // s = n - p
   int dim_design = object["df"]; // 3m + 1 (const) or 3m (none)
-  int dim_har = HARtrans.cols(); // 22m + 1 (const) or 22m (none)
-  int month = object["month"];
   // (Phi, Sig) ~ MNIW
   Rcpp::List coef_and_sig = sim_mniw(
     num_sim, 
@@ -51,20 +49,14 @@ Rcpp::List forecast_bvharmn(Rcpp::List object, int step, int num_sim) {
   Eigen::MatrixXd point_forecast(step, dim); // h x m matrix
   Eigen::MatrixXd density_forecast(step, num_sim * dim); // h x Bm matrix
   Eigen::MatrixXd predictive_distn(step, num_sim * dim); // h x Bm matrix
-  Eigen::MatrixXd last_pvec(1, dim_har); // vectorize the last 22 observation and include 1
-  Eigen::MatrixXd tmp_vec(1, (month - 1) * dim);
-  Eigen::MatrixXd res(step, dim); // h x m matrix
+  bvhar::VharLag lag_state(response_mat, HARtrans); // [y(n), weekly and monthly mean, 1] = HARtrans %*% [y(n), ..., y(n - 21), 1]
   Eigen::VectorXd sig_closed(step); // se^2 for each forecast (except Sigma2 part, i.e. closed form)
   for (int i = 0; i < step; i++) {
     sig_closed(i) = 1.0;
   }
-  last_pvec(0, dim_har - 1) = 1.0;
-  for (int i = 0; i < month; i++) {
-    last_pvec.block(0, i * dim, 1, dim) = response_mat.block(num_design - 1 - i, 0, 1, dim);
-  }
-  sig_closed.block(0, 0, 1, 1) += last_pvec * transformed_prec_mat * last_pvec.transpose();
-  point_forecast.block(0, 0, 1, dim) = last_pvec * HARtrans.transpose() * posterior_mean_mat; // y(n + 1)^T = [y(n)^T, ..., y(n - p + 1)^T, 1] %*% t(HARtrans) %*% Phihat
-  density_forecast.block(0, 0, 1, num_sim * dim) = last_pvec * HARtrans.transpose() * coef_gen; // (1, k0) x (k0, h) x (h, Bm) = (1, Bm)
+  sig_closed[0] += lag_state.getHar().transpose() * posterior_mn_scale_u * lag_state.getHar();
+  point_forecast.row(0) = lag_state.getHar().transpose() * posterior_mean_mat; // y(n + 1)^T = [y(n)^T, ..., y(n - p + 1)^T, 1] %*% t(HARtrans) %*% Phihat
+  density_forecast.row(0) = lag_state.getHar().transpose() * coef_gen; // (1, h) x (h, Bm) = (1, Bm)
   // one-step ahead forecasting
   Eigen::MatrixXd sig_mat = sig_gen.block(0, 0, dim, dim); // First Sighat
   for (int b = 0; b < num_sim; b++) {
@@ -82,14 +74,12 @@ Rcpp::List forecast_bvharmn(Rcpp::List object, int step, int num_sim) {
   }
   // Next h - 1: recursively
   for (int i = 1; i < step; i++) {
-    tmp_vec = last_pvec.block(0, 0, 1, (month - 1) * dim); // remove the last m (except 1)
-    last_pvec.block(0, dim, 1, (month - 1) * dim) = tmp_vec;
-    last_pvec.block(0, 0, 1, dim) = point_forecast.block(i - 1, 0, 1, dim);
-    sig_closed.block(i, 0, 1, 1) += last_pvec * transformed_prec_mat * last_pvec.transpose();
+    lag_state.update(point_forecast.row(i - 1).transpose()); // yhat(n + 1) enters as the latest lag
+    sig_closed[i] += lag_state.getHar().transpose() * posterior_mn_scale_u * lag_state.getHar();
     // y(n + 2)^T = [yhat(n + 1)^T, y(n)^T, ... y(n - p + 2)^T, 1] %*% t(HARtrans) %*% Phihat
-    point_forecast.block(i, 0, 1, dim) = last_pvec * HARtrans.transpose() * posterior_mean_mat;
+    point_forecast.row(i) = lag_state.getHar().transpose() * posterior_mean_mat;
     // Predictive distribution
-    density_forecast.block(i, 0, 1, num_sim * dim) = last_pvec * HARtrans.transpose() * coef_gen;
+    density_forecast.row(i) = lag_state.getHar().transpose() * coef_gen;
     for (int b = 0; b < num_sim; b++) {
       sig_mat = sig_gen.block(0, b * dim, dim, dim); // b-th Sighat
       predictive_distn.block(i, b * dim, 1, dim) = sim_matgaussian(
@@ -125,18 +115,12 @@ Eigen::MatrixXd forecast_bvharssvs(int num_chains, int month, int step,
 																	 Eigen::MatrixXd psi_record) {
   int num_sim = num_chains > 1 ? phi_record.rows() / num_chains : phi_record.rows();
   int dim = response_mat.cols();
-  int num_design = response_mat.rows();
-  int lag_var = HARtrans.cols();
+  bvhar::check_har_trans(HARtrans, dim, month);
   int dim_har = HARtrans.rows();
 	int num_coef = dim_har * dim;
   Eigen::VectorXd density_forecast(dim);
   Eigen::MatrixXd predictive_distn(step * num_chains, num_sim * dim);
-  Eigen::VectorXd last_pvec(lag_var);
-	Eigen::VectorXd tmp_vec(lag_var - dim);
-  last_pvec[lag_var - 1] = 1.0;
-  for (int i = 0; i < month; i++) {
-    last_pvec.segment(i * dim, dim) = response_mat.row(num_design - 1 - i);
-  }
+  Eigen::MatrixXd coef_mat(dim_har, dim);
   Eigen::MatrixXd chol_factor(dim, dim);
   Eigen::MatrixXd sig_cycle(dim, dim);
 	Eigen::MatrixXd phi_chain(num_sim, num_coef);
@@ -147,27 +131,14 @@ Eigen::MatrixXd forecast_bvharssvs(int num_chains, int month, int step,
 		eta_chain = eta_record.middleRows(chain * num_sim, num_sim);
 		psi_chain = psi_record.middleRows(chain * num_sim, num_sim);
 		for (int b = 0; b < num_sim; b++) {
-			density_forecast = last_pvec.transpose() * HARtrans.transpose() * bvhar::unvectorize(phi_chain.row(b).eval(), dim);
+			bvhar::VharLag lag_state(response_mat, HARtrans); // each draw has its own recursion
+			coef_mat = bvhar::unvectorize(phi_chain.row(b).eval(), dim);
 			chol_factor = bvhar::build_chol(psi_chain.row(b), eta_chain.row(b));
 			sig_cycle = (chol_factor * chol_factor.transpose()).inverse();
-			predictive_distn.block(chain * step, b * dim, 1, dim) = sim_mgaussian_chol(1, density_forecast, sig_cycle);
-		}
-	}
-  if (step == 1) {
-    return predictive_distn;
-  }
-	for (int chain = 0; chain < num_chains; chain++) {
-		phi_chain = phi_record.middleRows(chain * num_sim, num_sim);
-		eta_chain = eta_record.middleRows(chain * num_sim, num_sim);
-		psi_chain = psi_record.middleRows(chain * num_sim, num_sim);
-		for (int i = 1; i < step; i++) {
-			for (int b = 0; b < num_sim; b++) {
-				tmp_vec = last_pvec.head(lag_var - dim);
-				last_pvec << density_forecast, tmp_vec;
-				density_forecast = last_pvec.transpose() * HARtrans.transpose() * bvhar::unvectorize(phi_chain.row(b).eval(), dim);
-				chol_factor = bvhar::build_chol(psi_chain.row(b), eta_chain.row(b));
-				sig_cycle = (chol_factor * chol_factor.transpose()).inverse();
+			for (int i = 0; i < step; i++) {
+				density_forecast = coef_mat.transpose() * lag_state.getHar();
 				predictive_distn.block(chain * step + i, b * dim, 1, dim) = sim_mgaussian_chol(1, density_forecast, sig_cycle);
+				lag_state.update(density_forecast);
 			}
 		}
 	}
@@ -193,18 +164,12 @@ Eigen::MatrixXd forecast_bvharhs(int num_chains, int month, int step,
 																 Eigen::VectorXd sigma_record) {
   int num_sim = num_chains > 1 ? phi_record.rows() / num_chains : phi_record.rows();
   int dim = response_mat.cols();
-  int num_design = response_mat.rows();
-  int lag_var = HARtrans.cols();
+  bvhar::check_har_trans(HARtrans, dim, month);
   int dim_har = HARtrans.rows();
 	int num_coef = dim_har * dim;
   Eigen::VectorXd density_forecast(dim);
   Eigen::MatrixXd predictive_distn(step * num_chains, num_sim * dim);
-  Eigen::VectorXd last_pvec(lag_var);
-	Eigen::VectorXd tmp_vec(lag_var - dim);
-  last_pvec[lag_var - 1] = 1.0;
-  for (int i = 0; i < month; i++) {
-    last_pvec.segment(i * dim, dim) = response_mat.row(num_design - 1 - i);
-  }
+  Eigen::MatrixXd coef_mat(dim_har, dim);
   Eigen::MatrixXd sig_cycle(dim, dim);
 	Eigen::MatrixXd phi_chain(num_sim, num_coef);
 	Eigen::VectorXd sig_chain(num_sim);
@@ -212,26 +177,14 @@ Eigen::MatrixXd forecast_bvharhs(int num_chains, int month, int step,
 		phi_chain = phi_record.middleRows(chain * num_sim, num_sim);
 		sig_chain = sigma_record.segment(chain * num_sim, num_sim);
 		for (int b = 0; b < num_sim; b++) {
-			density_forecast = last_pvec.transpose() * HARtrans.transpose() * bvhar::unvectorize(phi_chain.row(b).eval(), dim);
+			bvhar::VharLag lag_state(response_mat, HARtrans); // each draw has its own recursion
+			coef_mat = bvhar::unvectorize(phi_chain.row(b).eval(), dim);
 			sig_cycle.setIdentity();
 			sig_cycle *= sig_chain[b];
-			predictive_distn.block(chain * step, b * dim, 1, dim) = sim_mgaussian_chol(1, density_forecast, sig_cycle);
-		}
-	}
-  if (step == 1) {
-		return predictive_distn;
-  }
-	for (int chain = 0; chain < num_chains; chain++) {
-		phi_chain = phi_record.middleRows(chain * num_sim, num_sim);
-		sig_chain = sigma_record.segment(chain * num_sim, num_sim);
-		for (int i = 1; i < step; i++) {
-			for (int b = 0; b < num_sim; b++) {
-				tmp_vec = last_pvec.head(lag_var - dim);
-				last_pvec << density_forecast, tmp_vec;
-				density_forecast = last_pvec.transpose() * HARtrans.transpose() * bvhar::unvectorize(phi_chain.row(b).eval(), dim);
-				sig_cycle.setIdentity();
-				sig_cycle *= sig_chain[b];
+			for (int i = 0; i < step; i++) {
+				density_forecast = coef_mat.transpose() * lag_state.getHar();
 				predictive_distn.block(chain * step + i, b * dim, 1, dim) = sim_mgaussian_chol(1, density_forecast, sig_cycle);
+				lag_state.update(density_forecast);
 			}
 		}
 	}
@@ -250,24 +203,12 @@ Eigen::MatrixXd forecast_bvharhs(int num_chains, int month, int step,
 // [[Rcpp::export]]
 Eigen::MatrixXd forecast_bvharsv(int month, int step, Eigen::MatrixXd response_mat, Eigen::MatrixXd coef_mat, Eigen::MatrixXd HARtrans) {
   int dim = response_mat.cols();
-  int num_design = response_mat.rows();
-  int dim_har = HARtrans.cols();
+  bvhar::check_har_trans(HARtrans, dim, month);
   Eigen::MatrixXd point_forecast(step, dim);
-  Eigen::VectorXd last_pvec(dim_har);
-  Eigen::VectorXd tmp_vec((month - 1) * dim);
-  last_pvec[dim_har - 1] = 1.0;
-  for (int i = 0; i < month; i++) {
-    last_pvec.segment(i * dim, dim) = response_mat.row(num_design - 1 - i);
-  }
-  point_forecast.row(0) = last_pvec.transpose() * HARtrans.transpose() * coef_mat;
-  if (step == 1) {
-    return point_forecast;
-  }
-  for (int i = 1; i < step; i++) {
-    tmp_vec = last_pvec.segment(0, (month - 1) * dim);
-    last_pvec.segment(dim, (month - 1) * dim) = tmp_vec;
-    last_pvec.segment(0, dim) = point_forecast.row(i - 1);
-    point_forecast.row(i) = last_pvec.transpose() * HARtrans.transpose() * coef_mat;
+  bvhar::VharLag lag_state(response_mat, HARtrans);
+  for (int i = 0; i < step; i++) {
+    point_forecast.row(i) = lag_state.getHar().transpose() * coef_mat;
+    lag_state.update(point_forecast.row(i).transpose());
   }
   return point_forecast;
 }
@@ -285,86 +226,15 @@ Eigen::MatrixXd forecast_bvharsv(int month, int step, Eigen::MatrixXd response_m
 Eigen::MatrixXd forecast_bvharsv_density(int num_chains, int month, int step, Eigen::MatrixXd response_mat, Eigen::MatrixXd HARtrans,
 																 				 Eigen::MatrixXd phi_record, Eigen::MatrixXd h_last_record,
 																				 Eigen::MatrixXd a_record, Eigen::MatrixXd sigh_record, bool include_mean) {
-	int num_sim = num_chains > 1 ? phi_record.rows() / num_chains : phi_record.rows();
+  int num_sim = num_chains > 1 ? phi_record.rows() / num_chains : phi_record.rows();
   int dim = response_mat.cols();
-  int num_design = response_mat.rows();
-  int lag_var = HARtrans.cols(); // month * dim( + 1)
-  int dim_har = HARtrans.rows(); // 3 * dim( + 1)
-	int num_coef = dim_har * dim;
-	int num_alpha = include_mean ? num_coef - dim : num_coef;
-  Eigen::VectorXd density_forecast(dim);
+  bvhar::check_har_trans(HARtrans, dim, month);
   Eigen::MatrixXd predictive_distn(step * num_chains, num_sim * dim);
-  Eigen::VectorXd last_pvec(lag_var);
-	Eigen::VectorXd tmp_vec(lag_var - dim); // (month - 1) * dim (+ 1)
-  Eigen::VectorXd sv_update(dim);
-  Eigen::MatrixXd sv_cov = Eigen::MatrixXd::Zero(dim, dim);
-  last_pvec[lag_var - 1] = 1.0;
-  for (int i = 0; i < month; i++) {
-    last_pvec.segment(i * dim, dim) = response_mat.row(num_design - 1 - i);
-  }
-	Eigen::MatrixXd coef_mat_record(dim_har, dim); // include constant term
-  Eigen::MatrixXd contem_mat = Eigen::MatrixXd::Zero(dim, dim);
-  Eigen::MatrixXd tvp_lvol = Eigen::MatrixXd::Zero(dim, dim);
-  Eigen::MatrixXd tvp_prec(dim, dim);
-	Eigen::MatrixXd phi_chain(num_sim, num_coef);
-	Eigen::MatrixXd h_chain(num_sim, dim);
-	Eigen::MatrixXd a_chain(num_sim, dim * (dim - 1) / 2);
-	Eigen::MatrixXd sigh_chain(num_sim, dim);
-	for (int chain = 0; chain < num_chains; chain++) {
-		phi_chain = phi_record.middleRows(chain * num_sim, num_sim);
-		h_chain = h_last_record.middleRows(chain * num_sim, num_sim);
-		a_chain = a_record.middleRows(chain * num_sim, num_sim);
-		sigh_chain = sigh_record.middleRows(chain * num_sim, num_sim);
-		for (int b = 0; b < num_sim; b++) {
-			coef_mat_record.topRows(3 * dim) = bvhar::unvectorize(phi_chain.row(b).head(num_alpha).transpose().eval(), dim);
-			if (include_mean) {
-				coef_mat_record.bottomRows(1) = phi_chain.row(b).tail(dim);
-			}
-			density_forecast = last_pvec.transpose() * HARtrans.transpose() * coef_mat_record;
-			sv_cov.diagonal() = 1 / sigh_chain.row(b).array(); // covariance of h_t
-			sv_update = bvhar::vectorize_eigen(
-				sim_mgaussian_chol(1, h_chain.row(b), sv_cov)
-			); // h_T+1 = h_T + u_T
-			tvp_lvol.diagonal() = 1 / sv_update.array();
-			contem_mat = bvhar::build_inv_lower(dim, a_chain.row(b));
-			tvp_prec = contem_mat.transpose() * tvp_lvol * contem_mat; // L^T D_T  L
-			predictive_distn.block(chain * step, b * dim, 1, dim) = sim_mgaussian_chol(
-				1, density_forecast, tvp_prec.inverse()
-			);
-		}
-	}
-  if (step == 1) {
-		return predictive_distn;
-  }
-	for (int chain = 0; chain < num_chains; chain++) {
-		phi_chain = phi_record.middleRows(chain * num_sim, num_sim);
-		h_chain = h_last_record.middleRows(chain * num_sim, num_sim);
-		a_chain = a_record.middleRows(chain * num_sim, num_sim);
-		sigh_chain = sigh_record.middleRows(chain * num_sim, num_sim);
-		for (int i = 1; i < step; i++) {
-			for (int b = 0; b < num_sim; b++) {
-				tmp_vec = last_pvec.head(lag_var - dim);
-				last_pvec << density_forecast, tmp_vec;
-				coef_mat_record.topRows(3 * dim) = bvhar::unvectorize(phi_chain.row(b).head(num_alpha).transpose().eval(), dim);
-				if (include_mean) {
-					coef_mat_record.bottomRows(1) = phi_chain.row(b).tail(dim);
-				}
-				density_forecast = last_pvec.transpose() * HARtrans.transpose() * coef_mat_record;
-				sv_cov.diagonal() = 1 / sigh_chain.row(b).array(); // covariance of h_t
-				sv_update = bvhar::vectorize_eigen(
-					sim_mgaussian_chol(1, h_chain.row(b), sv_cov)
-				); // h_T+1 = h_T + u_T
-				tvp_lvol.diagonal() = 1 / sv_update.array().exp();
-				contem_mat = bvhar::build_inv_lower(dim, a_chain.row(b));
-				tvp_prec = contem_mat.transpose() * tvp_lvol * contem_mat; // L^T D_T  L
-				predictive_distn.block(chain * step + i, b * dim, 1, dim) = sim_mgaussian_chol(
-					1,
-					density_forecast,
-					tvp_prec.inverse()
-				);
-			}
-		}
-	}
+	bvhar::VharLag lag_init(response_mat, HARtrans);
+	bvhar::dispatch_dim<bvhar::SvDensityForecast>(
+		dim, predictive_distn, lag_init, num_chains, step,
+		phi_record, h_last_record, a_record, sigh_record, include_mean
+	);
 	return predictive_distn; // rbind(chains), cbind(sims)
 }
 
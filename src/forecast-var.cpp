@@ -1,4 +1,4 @@
-#include <RcppEigen.h>
+#include "bvharlag.h"
 
 //' Forecasting Vector Autoregression
 //' 
@@ -16,22 +16,12 @@ Eigen::MatrixXd forecast_var(Rcpp::List object, int step) {
   Eigen::MatrixXd coef_mat = object["coefficients"]; // bhat
   int dim = object["m"]; // dimension of time series
   int var_lag = object["p"]; // VAR(p)
-  int num_design = object["obs"]; // s = n - p
   int dim_design = object["df"]; // k = mp + 1
-  Eigen::MatrixXd last_pvec(1, dim_design); // vectorize the last p observation and include 1
-  Eigen::MatrixXd tmp_vec(1, (var_lag - 1) * dim); // temporary vector to move first m(p - 1) element of last_pvec
+  bvhar::VarLag lag_state(response_mat, var_lag, dim_design == var_lag * dim + 1); // [y(n)^T, ..., y(n - p + 1)^T, 1]
   Eigen::MatrixXd res(step, dim); // h x m matrix
-  last_pvec(0, dim_design - 1) = 1.0; // when constant term exists
-  for (int i = 0; i < var_lag; i++) {
-    last_pvec.block(0, i * dim, 1, dim) = response_mat.block(num_design - 1 - i, 0, 1, dim);
-  }
-  res.block(0, 0, 1, dim) = last_pvec * coef_mat; // y(n + 1)^T = [y(n)^T, ..., y(n - p + 1)^T, 1] %*% Bhat
-  if (step == 1) return res;
-  for (int i = 1; i < step; i++) { // Next h - 1: recursively
-    tmp_vec = last_pvec.block(0, 0, 1, (var_lag - 1) * dim); // remove the last m (except 1)
-    last_pvec.block(0, dim, 1, (var_lag - 1) * dim) = tmp_vec;
-    last_pvec.block(0, 0, 1, dim) = res.block(i - 1, 0, 1, dim);
-    res.block(i, 0, 1, dim) = last_pvec * coef_mat; // y(n + 2)^T = [yhat(n + 1)^T, y(n)^T, ... y(n - p + 2)^T, 1] %*% Bhat
+  for (int i = 0; i < step; i++) {
+    res.row(i) = lag_state.multiply(coef_mat); // y(n + 1)^T = [y(n)^T, ..., y(n - p + 1)^T, 1] %*% Bhat
+    lag_state.update(res.row(i).transpose()); // yhat(n + 1) enters as the latest lag
   }
   return res;
 }
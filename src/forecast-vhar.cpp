@@ -1,4 +1,4 @@
-#include <RcppEigen.h>
+#include "bvharlag.h"
 
 //' Forecasting Vector HAR
 //' 
@@ -17,25 +17,11 @@ Eigen::MatrixXd forecast_vhar(Rcpp::List object, int step) {
   Eigen::MatrixXd coef_mat = object["coefficients"]; // bhat
   int dim = object["m"]; // dimension of time series
   Eigen::MatrixXd HARtrans = object["HARtrans"]; // HAR transformation
-  int num_design = object["obs"]; // s = n - p
-  int dim_har = HARtrans.cols(); // 22m + 1 (const) or 22m (none)
-  int month = object["month"];
-  Eigen::MatrixXd last_pvec(1, dim_har); // vectorize the last 22 observation and include 1
-  Eigen::MatrixXd tmp_vec(1, (month - 1) * dim); // temporary vector to move first 21 observations of last_pvec
+  bvhar::VharLag lag_state(response_mat, HARtrans); // [y(n), mean(y(n), ..., y(n - 4)), mean(y(n), ..., y(n - 21)), 1]
   Eigen::MatrixXd res(step, dim); // h x m matrix
-  last_pvec(0, dim_har - 1) = 1.0;
-  for (int i = 0; i < month; i++) {
-    last_pvec.block(0, i * dim, 1, dim) = response_mat.block(num_design - 1 - i, 0, 1, dim);
-  }
-  res.block(0, 0, 1, dim) = last_pvec * HARtrans.transpose() * coef_mat; // y(n + 1)^T = [y(n)^T, ..., y(n - p + 1)^T, 1] %*% t(HARtrans) %*% Phihat
-  if (step == 1) {
-    return res;
-  }
-  for (int i = 1; i < step; i++) { // Next h - 1: recursively
-    tmp_vec = last_pvec.block(0, 0, 1, (month - 1) * dim); // remove the last m (except 1)
-    last_pvec.block(0, dim, 1, (month - 1) * dim) = tmp_vec;
-    last_pvec.block(0, 0, 1, dim) = res.block(i - 1, 0, 1, dim);
-    res.block(i, 0, 1, dim) = last_pvec * HARtrans.transpose() * coef_mat; // y(n + 2)^T = [yhat(n + 1)^T, y(n)^T, ... y(n - p + 2)^T, 1] %*% t(HARtrans) %*% Phihat
+  for (int i = 0; i < step; i++) {
+    res.row(i) = lag_state.getHar().transpose() * coef_mat; // y(n + 1)^T = [daily, weekly, monthly, 1] %*% Phihat
+    lag_state.update(res.row(i).transpose()); // yhat(n + 1) enters as the latest lag
   }
   return res;
 }
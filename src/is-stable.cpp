@@ -1,4 +1,4 @@
-#include <RcppEigen.h>
+#include "bvharstructural.h"
 
 //' VAR(1) Representation Given VAR Coefficient Matrix
 //' 
@@ -89,3 +89,68 @@ Eigen::MatrixXd compute_vhar_stablemat(Rcpp::List object) {
   Eigen::MatrixXd res = compute_stablemat(hartrans_without_const.transpose() * coef_without_const);
   return res;
 }
+
+//' Stability of Each Posterior Draw of VAR
+//' 
+//' Compute the largest modulus of the VAR(1) form eigenvalues for every MCMC draw
+//' 
+//' @param alpha_record MCMC record of VAR coefficients without constant term
+//' @param var_lag VAR lag
+//' @param compute_root Compute every largest modulus (`TRUE`) or skip the draws whose coefficient norm already guarantees stability (`FALSE`)
+//' @param nthreads Number of threads for openmp
+//' @details
+//' If \eqn{\sum_i \lVert A_i \rVert_\infty < 1}, every root of VAR(1) form lies inside of unit circle.
+//' When `compute_root = FALSE`, eigen decomposition is skipped for such draws and their `max_modulus` is `NaN`.
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List check_var_stable_draws(Eigen::MatrixXd alpha_record, int var_lag, bool compute_root, int nthreads) {
+  int num_draws = alpha_record.rows();
+  int dim = static_cast<int>(std::round(std::sqrt(static_cast<double>(alpha_record.cols()) / var_lag)));
+  Eigen::VectorXd max_modulus = Eigen::VectorXd::Constant(num_draws, std::numeric_limits<double>::quiet_NaN());
+  std::vector<int> is_stable(num_draws);
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(nthreads)
+#endif
+  {
+    Eigen::MatrixXd companion = compute_stablemat(Eigen::MatrixXd::Zero(dim * var_lag, dim)); // workspace of each thread
+  #ifdef _OPENMP
+    #pragma omp for
+  #endif
+    for (int i = 0; i < num_draws; i++) {
+      Eigen::MatrixXd coef_mat = alpha_record.row(i).reshaped(dim * var_lag, dim);
+      if (!compute_root && bvhar::compute_companion_norm(coef_mat, var_lag) < 1) {
+        is_stable[i] = 1;
+        continue;
+      }
+      max_modulus[i] = bvhar::compute_spectral_radius(coef_mat, var_lag, companion);
+      is_stable[i] = max_modulus[i] < 1;
+    }
+  }
+  return Rcpp::List::create(
+    Rcpp::Named("stable") = Rcpp::LogicalVector(is_stable.begin(), is_stable.end()),
+    Rcpp::Named("max_modulus") = max_modulus
+  );
+}
+
+//' Stability of Each Posterior Draw of VHAR
+//' 
+//' Compute the largest modulus of the VAR(1) form eigenvalues for every MCMC draw of VHAR
+//' 
+//' @param phi_record MCMC record of VHAR coefficients without constant term
+//' @param HARtrans VHAR linear transformation matrix without constant term
+//' @param compute_root Compute every largest modulus (`TRUE`) or skip the draws whose coefficient norm already guarantees stability (`FALSE`)
+//' @param nthreads Number of threads for openmp
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Rcpp::List check_vhar_stable_draws(Eigen::MatrixXd phi_record, Eigen::MatrixXd HARtrans, bool compute_root, int nthreads) {
+  int num_draws = phi_record.rows();
+  int dim = HARtrans.rows() / 3;
+  int month = HARtrans.cols() / dim;
+  Eigen::MatrixXd alpha_record(num_draws, dim * dim * month);
+  for (int i = 0; i < num_draws; i++) {
+    alpha_record.row(i) = (HARtrans.transpose() * phi_record.row(i).reshaped(3 * dim, dim)).reshaped().transpose(); // A = T^T Phi
+  }
+  return check_var_stable_draws(alpha_record, month, compute_root, nthreads);
+}
@@ -1,5 +1,7 @@
 #include "bvharsim.h"
 #include "bvhardesign.h"
+#include "bvharlag.h"
+#include "bvharomp.h"
 
 //' Generate Multivariate Time Series Process Following VAR(p)
 //' 
@@ -27,11 +29,7 @@ Eigen::MatrixXd sim_var_eigen(int num_sim,
   int dim = sig_error.cols(); // m: dimension of time series
   int dim_design = var_coef.rows(); // k = mp + 1 (const) or mp (none)
   int num_rand = num_sim + num_burn; // sim + burnin
-  Eigen::MatrixXd obs_p(1, dim_design); // row vector of X0: yp^T, ..., y1^T, (1)
-  obs_p(0, dim_design - 1) = 1.0; // for constant term if exists
-  for (int i = 0; i < var_lag; i++) {
-    obs_p.block(0, i * dim, 1, dim) = init.row(var_lag - i - 1);
-  }
+  bvhar::VarLag lag_state(init, var_lag, dim_design == var_lag * dim + 1); // yp^T, ..., y1^T, (1)
   Eigen::MatrixXd res(num_rand, dim); // Output: from y(p + 1)^T to y(n + p)^T
   // epsilon ~ N(0, sig_error)
   Eigen::VectorXd sig_mean = Eigen::VectorXd::Zero(dim); // zero mean
@@ -47,13 +45,9 @@ Eigen::MatrixXd sim_var_eigen(int num_sim,
   default:
     Rcpp::stop("Invalid 'process' option.");
   }
-  res.row(0) = obs_p * var_coef + error_term.row(0); // y(p + 1) = [yp^T, ..., y1^T, 1] A + eps(T)
-  for (int i = 1; i < num_rand; i++) {
-    for (int t = 1; t < var_lag; t++) {
-      obs_p.block(0, t * dim, 1, dim) = obs_p.block(0, (t - 1) * dim, 1, dim);
-    }
-    obs_p.block(0, 0, 1, dim) = res.row(i - 1);
-    res.row(i) = obs_p * var_coef + error_term.row(i); // yi = [y(i-1), ..., y(i-p), 1] A + eps(i)
+  for (int i = 0; i < num_rand; i++) {
+    res.row(i) = lag_state.multiply(var_coef) + error_term.row(i); // yi = [y(i-1), ..., y(i-p), 1] A + eps(i)
+    lag_state.update(res.row(i).transpose());
   }
   return res.bottomRows(num_rand - num_burn);
 }
@@ -84,11 +78,7 @@ Eigen::MatrixXd sim_var_chol(int num_sim,
   int dim = sig_error.cols();
   int dim_design = var_coef.rows();
   int num_rand = num_sim + num_burn;
-  Eigen::MatrixXd obs_p(1, dim_design);
-  obs_p(0, dim_design - 1) = 1.0;
-  for (int i = 0; i < var_lag; i++) {
-    obs_p.block(0, i * dim, 1, dim) = init.row(var_lag - i - 1);
-  }
+  bvhar::VarLag lag_state(init, var_lag, dim_design == var_lag * dim + 1);
   Eigen::MatrixXd res(num_rand, dim);
   Eigen::VectorXd sig_mean = Eigen::VectorXd::Zero(dim);
   // Eigen::MatrixXd error_term = sim_mgaussian_chol(num_rand, sig_mean, sig_error); // normal using cholesky
@@ -103,13 +93,9 @@ Eigen::MatrixXd sim_var_chol(int num_sim,
   default:
     Rcpp::stop("Invalid 'process' option.");
   }
-  res.row(0) = obs_p * var_coef + error_term.row(0);
-  for (int i = 1; i < num_rand; i++) {
-    for (int t = 1; t < var_lag; t++) {
-      obs_p.block(0, t * dim, 1, dim) = obs_p.block(0, (t - 1) * dim, 1, dim);
-    }
-    obs_p.block(0, 0, 1, dim) = res.row(i - 1);
-    res.row(i) = obs_p * var_coef + error_term.row(i);
+  for (int i = 0; i < num_rand; i++) {
+    res.row(i) = lag_state.multiply(var_coef) + error_term.row(i);
+    lag_state.update(res.row(i).transpose());
   }
   return res.bottomRows(num_rand - num_burn);
 }
@@ -141,19 +127,8 @@ Eigen::MatrixXd sim_vhar_eigen(int num_sim,
                                double mvt_df) {
   int dim = sig_error.cols(); // m: dimension of time series
   int num_har = vhar_coef.rows(); // 3m + 1 (const) or 3m (none)
-  int dim_har = month * dim + 1; // 22m + 1 (const)
-  bool include_mean = true;
-  if (num_har == 3 * dim) {
-    dim_har -= 1;
-    include_mean = false;
-  } // 22m (none)
   int num_rand = num_sim + num_burn; // sim + burnin
-  Eigen::MatrixXd hartrans_mat = bvhar::build_vhar(dim, week, month, include_mean).block(0, 0, num_har, dim_har);
-  Eigen::MatrixXd obs_p(1, dim_har); // row vector of X0: y22^T, ..., y1^T, 1
-  obs_p(0, dim_har - 1) = 1.0; // for constant term if exists
-  for (int i = 0; i < month; i++) {
-    obs_p.block(0, i * dim, 1, dim) = init.row(month - 1 - i);
-  }
+  bvhar::VharLag lag_state(init, week, month, num_har == 3 * dim + 1); // HAR regressor of y(23): daily, weekly, monthly, 1
   Eigen::MatrixXd res(num_rand, dim); // Output: from y(23)^T to y(n + 22)^T
   // epsilon ~ N(0, sig_error)
   Eigen::VectorXd sig_mean = Eigen::VectorXd::Zero(dim); // zero mean
@@ -169,13 +144,9 @@ Eigen::MatrixXd sim_vhar_eigen(int num_sim,
   default:
     Rcpp::stop("Invalid 'process' option.");
   }
-  res.row(0) = obs_p * hartrans_mat.transpose() * vhar_coef + error_term.row(0);
-  for (int i = 1; i < num_rand; i++) {
-    for (int t = 1; t < month; t++) {
-      obs_p.block(0, t * dim, 1, dim) = obs_p.block(0, (t - 1) * dim, 1, dim);
-    }
-    obs_p.block(0, 0, 1, dim) = res.row(i - 1);
-    res.row(i) = obs_p * hartrans_mat.transpose() * vhar_coef + error_term.row(i);
+  for (int i = 0; i < num_rand; i++) {
+    res.row(i) = lag_state.getHar().transpose() * vhar_coef + error_term.row(i); // yi = [daily, weekly, monthly, 1] Phi + eps(i)
+    lag_state.update(res.row(i).transpose());
   }
   return res.bottomRows(num_rand - num_burn);
 }
@@ -215,19 +186,8 @@ Eigen::MatrixXd sim_vhar_chol(int num_sim,
                               double mvt_df) {
   int dim = sig_error.cols(); // m: dimension of time series
   int num_har = vhar_coef.rows(); // 3m + 1 (const) or 3m (none)
-  int dim_har = month * dim + 1; // 22m + 1 (const)
-  bool include_mean = true;
-  if (num_har == 3 * dim) {
-    dim_har -= 1;
-    include_mean = false;
-  } // 22m (none)
   int num_rand = num_sim + num_burn; // sim + burnin
-  Eigen::MatrixXd hartrans_mat = bvhar::build_vhar(dim, week, month, include_mean).block(0, 0, num_har, dim_har);
-  Eigen::MatrixXd obs_p(1, dim_har); // row vector of X0: y22^T, ..., y1^T, 1
-  obs_p(0, dim_har - 1) = 1.0; // for constant term if exists
-  for (int i = 0; i < month; i++) {
-    obs_p.block(0, i * dim, 1, dim) = init.row(month - 1 - i);
-  }
+  bvhar::VharLag lag_state(init, week, month, num_har == 3 * dim + 1); // HAR regressor of y(23): daily, weekly, monthly, 1
   Eigen::MatrixXd res(num_rand, dim); // Output: from y(23)^T to y(n + 22)^T
   // epsilon ~ N(0, sig_error)
   Eigen::VectorXd sig_mean = Eigen::VectorXd::Zero(dim); // zero mean
@@ -243,13 +203,147 @@ Eigen::MatrixXd sim_vhar_chol(int num_sim,
   default:
     Rcpp::stop("Invalid 'process' option.");
   }
-  res.row(0) = obs_p * hartrans_mat.transpose() * vhar_coef + error_term.row(0);
-  for (int i = 1; i < num_rand; i++) {
-    for (int t = 1; t < month; t++) {
-      obs_p.block(0, t * dim, 1, dim) = obs_p.block(0, (t - 1) * dim, 1, dim);
-    }
-    obs_p.block(0, 0, 1, dim) = res.row(i - 1);
-    res.row(i) = obs_p * hartrans_mat.transpose() * vhar_coef + error_term.row(i);
+  for (int i = 0; i < num_rand; i++) {
+    res.row(i) = lag_state.getHar().transpose() * vhar_coef + error_term.row(i); // yi = [daily, weekly, monthly, 1] Phi + eps(i)
+    lag_state.update(res.row(i).transpose());
   }
   return res.bottomRows(num_rand - num_burn);
-}
\ No newline at end of file
+}
+
+// Advance Blocks of Paths Together
+//
+// Paths are split into as many blocks as seeds, and each block owns one RNG stream.
+// Column j of path l is column (l * m + j) of the result, i.e. array(num_sim, m, num_path) in R.
+template <typename PathLag>
+Eigen::MatrixXd sim_paths(std::vector<PathLag>& lag_states, const Eigen::VectorXi& block_start,
+													int num_sim, int num_burn, const Eigen::MatrixXd& coef_mat, const Eigen::MatrixXd& sig_error,
+													int process, double mvt_df, const Eigen::VectorXi& seed_block, int nthreads) {
+	int dim = sig_error.cols();
+	int num_block = seed_block.size();
+	int num_path = block_start[num_block];
+	Eigen::MatrixXd chol_upper;
+	switch (process) {
+	case 1:
+		chol_upper = sig_error.llt().matrixU();
+		break;
+	case 2:
+		chol_upper = (sig_error * (mvt_df - 2) / mvt_df).llt().matrixU();
+		break;
+	default:
+		Rcpp::stop("Invalid 'process' option.");
+	}
+	Eigen::MatrixXd res(num_sim, num_path * dim);
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nthreads)
+#endif
+	for (int b = 0; b < num_block; b++) {
+		boost::random::mt19937 rng(static_cast<unsigned int>(seed_block[b]));
+		int block_size = block_start[b + 1] - block_start[b];
+		Eigen::MatrixXd obs(block_size, dim);
+		for (int i = 0; i < num_sim + num_burn; i++) {
+			obs = lag_states[b].multiply(coef_mat) + bvhar::sim_innovation(block_size, chol_upper, process, mvt_df, rng); // paths x m
+			lag_states[b].update(obs);
+			if (i >= num_burn) {
+				res.row(i - num_burn).segment(block_start[b] * dim, block_size * dim) = obs.transpose().reshaped().transpose();
+			}
+		}
+	}
+	return res;
+}
+
+// First path of each block
+Eigen::VectorXi split_paths(int num_path, int num_block) {
+	if (num_block < 1 || num_block > num_path) {
+		Rcpp::stop("Number of seeds should be between 1 and 'num_path'.");
+	}
+	Eigen::VectorXi res(num_block + 1);
+	res[0] = 0;
+	for (int b = 0; b < num_block; b++) {
+		res[b + 1] = res[b] + num_path / num_block + (b < num_path % num_block ? 1 : 0);
+	}
+	return res;
+}
+
+//' Generate Many Paths Following VAR(p)
+//' 
+//' This function generates independent VAR(p) paths at once.
+//' 
+//' @param num_path Number of paths
+//' @param num_sim Number to generated process
+//' @param num_burn Number of burn-in
+//' @param var_coef VAR coefficient. The format should be the same as the output of [coef.varlse()] from [var_lm()]
+//' @param var_lag Lag of VAR
+//' @param sig_error Variance matrix of the error term. Try `diag(dim)`.
+//' @param init Initial y1, ..., yp matrix to simulate VAR model. Try `matrix(0L, nrow = var_lag, ncol = dim)`.
+//' @param process Process to generate error term: 1 (Gaussian) or 2 (Multivariate t)
+//' @param mvt_df DF of MVT
+//' @param seed_block Seed for each block of paths
+//' @param nthreads Number of threads
+//' @details
+//' Each block of paths uses its own RNG stream, and every path of the block moves forward together.
+//' @return num_sim x (dim * num_path) matrix
+//' @noRd
+// [[Rcpp::export]]
+Eigen::MatrixXd sim_var_batch(int num_path,
+                              int num_sim,
+                              int num_burn,
+                              Eigen::MatrixXd var_coef,
+                              int var_lag,
+                              Eigen::MatrixXd sig_error,
+                              Eigen::MatrixXd init,
+                              int process,
+                              double mvt_df,
+                              Eigen::VectorXi seed_block,
+                              int nthreads) {
+  int dim = sig_error.cols();
+  bool include_mean = var_coef.rows() == var_lag * dim + 1;
+  Eigen::VectorXi block_start = split_paths(num_path, seed_block.size());
+  std::vector<bvhar::VarPathLag> lag_states;
+  for (int b = 0; b < seed_block.size(); b++) {
+    lag_states.emplace_back(init, var_lag, include_mean, block_start[b + 1] - block_start[b]);
+  }
+  return sim_paths(lag_states, block_start, num_sim, num_burn, var_coef, sig_error, process, mvt_df, seed_block, nthreads);
+}
+
+//' Generate Many Paths Following VHAR
+//' 
+//' This function generates independent VHAR paths at once.
+//' 
+//' @param num_path Number of paths
+//' @param num_sim Number to generated process
+//' @param num_burn Number of burn-in
+//' @param vhar_coef VHAR coefficient
+//' @param week Order for weekly term. Try `5L`.
+//' @param month Order for monthly term. Try `22L`.
+//' @param sig_error Variance matrix of the error term. Try `diag(dim)`.
+//' @param init Initial y1, ..., y_month matrix to simulate VHAR model. Try `matrix(0L, nrow = month, ncol = dim)`.
+//' @param process Process to generate error term: 1 (Gaussian) or 2 (Multivariate t)
+//' @param mvt_df DF of MVT
+//' @param seed_block Seed for each block of paths
+//' @param nthreads Number of threads
+//' @details
+//' Each block of paths uses its own RNG stream, and HAR terms of every path are updated as running sums.
+//' @return num_sim x (dim * num_path) matrix
+//' @noRd
+// [[Rcpp::export]]
+Eigen::MatrixXd sim_vhar_batch(int num_path,
+                               int num_sim,
+                               int num_burn,
+                               Eigen::MatrixXd vhar_coef,
+                               int week,
+                               int month,
+                               Eigen::MatrixXd sig_error,
+                               Eigen::MatrixXd init,
+                               int process,
+                               double mvt_df,
+                               Eigen::VectorXi seed_block,
+                               int nthreads) {
+  int dim = sig_error.cols();
+  bool include_mean = vhar_coef.rows() == 3 * dim + 1;
+  Eigen::VectorXi block_start = split_paths(num_path, seed_block.size());
+  std::vector<bvhar::VharPathLag> lag_states;
+  for (int b = 0; b < seed_block.size(); b++) {
+    lag_states.emplace_back(init, week, month, include_mean, block_start[b + 1] - block_start[b]);
+  }
+  return sim_paths(lag_states, block_start, num_sim, num_burn, vhar_coef, sig_error, process, mvt_df, seed_block, nthreads);
+}
@@ -1,4 +1,5 @@
 #include "bvhardraw.h"
+#include "ols.h"
 
 //' Log of Multivariate Gamma Function
 //' 
@@ -131,20 +132,51 @@ double compute_fpe(Rcpp::List object) {
 //' @param lag_max Maximum Var lag to explore
 //' @param include_mean Add constant term
 //' 
+//' @details
+//' Every VAR(p) is fitted on the common sample of VAR(`lag_max`).
+//' The largest design is decomposed only once, and the residual cross-product of each smaller model is obtained from the nested QR factor.
+//' 
 //' @noRd
 // [[Rcpp::export]]
 Eigen::MatrixXd tune_var(Eigen::MatrixXd y, int lag_max, bool include_mean) {
-  Rcpp::Function fit("var_lm");
-  Eigen::MatrixXd ic_res(lag_max, 4); // matrix including information criteria: AIC-BIC-HQ-FPE
-  Rcpp::List var_mod;
-  for (int i = 0; i < lag_max; i++) {
-    var_mod = fit(y, i + 1, include_mean);
-    ic_res(i, 0) = compute_aic(var_mod);
-    ic_res(i, 1) = compute_bic(var_mod);
-    ic_res(i, 2) = compute_hq(var_mod);
-    ic_res(i, 3) = compute_fpe(var_mod);
+  if (lag_max < 1) {
+    Rcpp::stop("'lag_max' should be larger than or same as 1.");
+  }
+  if (y.rows() - lag_max <= y.cols() * lag_max + (include_mean ? 1 : 0)) {
+    Rcpp::stop("'lag_max' is too large: VAR('lag_max') needs more observations than coefficients of each equation.");
+  }
+  bvhar::OlsCriteria ic_fit(y, lag_max, include_mean);
+  return ic_fit.computeVarCriteria(); // matrix including information criteria: AIC-BIC-HQ-FPE
+}
+
+//' Choose the Best VHAR based on Information Criteria
+//' 
+//' This function computes AIC, FPE, BIC, and HQ of VHAR model for each week and month order pair.
+//' 
+//' @param y Time series data of which columns indicate the variables
+//' @param week Weekly order of each candidate
+//' @param month Monthly order of each candidate
+//' @param include_mean Add constant term
+//' @param nthreads Number of threads for openmp
+//' 
+//' @details
+//' Every candidate is fitted on the common sample of the largest `month`.
+//' Cross-products of VAR(max(`month`)) design are computed once and transformed by each HAR matrix.
+//' 
+//' @noRd
+// [[Rcpp::export]]
+Eigen::MatrixXd tune_vhar(Eigen::MatrixXd y, Eigen::VectorXi week, Eigen::VectorXi month, bool include_mean, int nthreads) {
+  if (week.size() != month.size()) {
+    Rcpp::stop("'week' and 'month' should have the same length.");
+  }
+  if (week.minCoeff() < 2 || (month - week).minCoeff() < 1) {
+    Rcpp::stop("Each 'month' should be larger than 'week' which should be larger than 1.");
+  }
+  if (y.rows() - month.maxCoeff() <= 3 * y.cols() + (include_mean ? 1 : 0)) {
+    Rcpp::stop("'month' is too large: VHAR needs more observations than coefficients of each equation.");
   }
-  return ic_res;
+  bvhar::OlsCriteria ic_fit(y, month.maxCoeff(), include_mean);
+  return ic_fit.computeVharCriteria(week, month, nthreads); // matrix including information criteria: AIC-BIC-HQ-FPE
 }
 
 //' log Density of Multivariate Normal with LDLT Precision Matrix